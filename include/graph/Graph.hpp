@@ -12,6 +12,7 @@
 #include <functional>
 #include <vector>
 #include <optional>
+#include <iosfwd>
 
 #include "impl/traits.hpp"
 #include "impl/Path.hpp"
@@ -366,11 +367,39 @@ namespace graph {
 			auto in_subtree(Vert source) const { return _subtree<impl::traits::In>(source); }
 			auto null_in_subtree() const { return in_subtree(null_vert()); }
 
-			// Finds the shortest paths between all pairs of vertices
+			// Finds the shortest paths between all pairs of vertices as predecessor and distance matrices
 			template <class Weight, class Compare = std::less<>, class Combine = std::plus<>>
 			auto all_pairs_shortest_paths(const Weight& weight,
 				const Compare& compare = {}, const Combine& combine = {}) const;
 
+			// Constructs a sparse matrix of edge weights by tail and head
+			template <class Weight>
+			auto adjacency_matrix(const Weight& weight) const;
+
+			// Finds the connected components, ignoring the direction of edges
+			auto connected_components() const;
+			// Finds the edges of a minimum spanning forest, ignoring the direction of edges
+			template <class Weight, class Compare = std::less<>>
+			auto minimum_spanning_forest(const Weight& weight, const Compare& compare = {}) const;
+			// Finds the edges of a minimum spanning forest in order of increasing weight
+			template <class Weight, class Compare = std::less<>>
+			auto minimum_spanning_forest_kruskal(const Weight& weight, const Compare& compare = {}) const;
+			// Finds a maximum flow from `s` to `t` and the source side of a minimum cut
+			template <class Capacity>
+			auto maximum_flow(const Vert& s, const Vert& t, const Capacity& capacity) const;
+			// Counts the triangles of the underlying simple undirected graph
+			std::size_t count_triangles() const;
+			// Finds the local clustering coefficient of each vertex
+			auto clustering_coefficients() const;
+			// Inserts the condensation of numbered components into `dag`
+			template <class Components, class Dag>
+			auto condensation(const Components& components, std::size_t count, Dag& dag) const;
+
+			// Constructs a contraction hierarchy for answering shortest path queries
+			template <class Weight, class Compare = std::less<>, class Combine = std::plus<>>
+			auto contraction_hierarchy(const Weight& weight,
+				const Compare& compare = {}, const Combine& combine = {}) const;
+
 			// Construct a view of this graph which can be streamed to and from dot format.
 			template <class... Args>
 			auto dot_format(Args&&...);
@@ -463,11 +492,70 @@ namespace graph {
 				return Out_edges::size(this->_impl(), v);
 			}
 
+			// Constructs a reusable traversal along out-edges
+			auto out_traversal() const;
+
+			// Finds the paths from a vertex with the fewest edges
+			auto breadth_first_search_from(const Vert& s) const;
+
 			template <class Weight, class Compare = std::less<>, class Combine = std::plus<>>
 			auto shortest_paths_from(const Vert& s, const Weight& weight,
 				const Compare& compare = {}, const Combine& combine = {}) const;
 
-			// auto scc() const;
+			// Orders the vertices topologically
+			auto topological_order() const;
+			// Finds the shortest paths from a vertex in a DAG
+			template <class Weight, class Compare = std::less<>, class Combine = std::plus<>>
+			auto dag_shortest_paths_from(const Vert& s, const Weight& weight,
+				const Compare& compare = {}, const Combine& combine = {}) const;
+			// Finds the longest paths from a vertex in a DAG
+			template <class Weight, class Compare = std::less<>, class Combine = std::plus<>>
+			auto dag_longest_paths_from(const Vert& s, const Weight& weight,
+				const Compare& compare = {}, const Combine& combine = {}) const;
+			// Finds the shortest paths from a vertex, allowing negative weights
+			template <class Weight, class Compare = std::less<>, class Combine = std::plus<>>
+			auto bellman_ford_shortest_paths_from(const Vert& s, const Weight& weight,
+				const Compare& compare = {}, const Combine& combine = {}) const;
+			// Finds the shortest paths from a vertex, allowing negative weights, relaxing only improved vertices
+			template <class Weight, class Compare = std::less<>, class Combine = std::plus<>>
+			auto spfa_shortest_paths_from(const Vert& s, const Weight& weight,
+				const Compare& compare = {}, const Combine& combine = {}) const;
+			// Finds up to `k` shortest loopless paths between two vertices
+			template <class Weight, class Compare = std::less<>, class Combine = std::plus<>>
+			auto k_shortest_paths(const Vert& s, const Vert& t, std::size_t k, const Weight& weight,
+				const Compare& compare = {}, const Combine& combine = {}) const;
+			// Finds the shortest paths from a vertex, kept up to date as edges are inserted or their weights decreased
+			template <class Weight, class Compare = std::less<>, class Combine = std::plus<>>
+			auto dynamic_shortest_paths_from(const Vert& s, const Weight& weight,
+				const Compare& compare = {}, const Combine& combine = {}) const;
+			// The result would outlive a temporary weight
+			template <class Weight, class Compare = std::less<>, class Combine = std::plus<>>
+			auto dynamic_shortest_paths_from(const Vert& s, const Weight&& weight,
+				const Compare& compare = {}, const Combine& combine = {}) const = delete;
+
+			// Finds the shortest paths between all pairs of vertices of a sparse graph
+			template <class Weight>
+			auto all_pairs_shortest_paths_sparse(const Weight& weight) const;
+			// Passes the distances from each vertex to `row`, called serially but from worker threads
+			template <class Weight, class Row>
+			void all_pairs_shortest_paths_sparse(const Weight& weight, Row&& row) const;
+
+			// Ranks vertices by PageRank
+			auto pagerank(double damping = 0.85, double tolerance = 1e-6) const;
+			// Approximates PageRank personalized to a vertex
+			auto personalized_pagerank(const Vert& s, double damping = 0.85, double epsilon = 1e-6) const;
+
+			// Finds the betweenness centrality of each vertex
+			template <class Weight = std::nullptr_t, class Compare = std::less<>, class Combine = std::plus<>>
+			auto betweenness_centrality(const Weight& weight = nullptr,
+				const Compare& compare = {}, const Combine& combine = {}) const;
+			// Estimates betweenness centrality from sampled sources
+			template <class Random, class Weight = std::nullptr_t, class Compare = std::less<>, class Combine = std::plus<>>
+			auto approximate_betweenness_centrality(double epsilon, double delta, Random& random,
+				const Weight& weight = nullptr, const Compare& compare = {}, const Combine& combine = {}) const;
+
+			// Finds the strongly connected components in reverse topological order
+			auto scc() const;
 
 			template <class WM, class Compare = std::less<>>
 			auto minimum_tree_reachable_from(const Vert& s, const WM& weight, const Compare& compare = {}) const;
@@ -496,11 +584,15 @@ namespace graph {
 				return In_edges::size(this->_impl(), v);
 			}
 
+			// Constructs a reusable traversal along in-edges
+			auto in_traversal() const;
+
 			template <class Weight, class Compare = std::less<>, class Combine = std::plus<>>
 			auto shortest_paths_to(const Vert& t, const Weight& weight,
 				const Compare& compare = {}, const Combine& combine = {}) const;
 
-			// auto scc() const;
+			// Finds the strongly connected components in topological order
+			auto scc() const;
 
 			template <class WM, class Compare = std::less<>>
 			auto minimum_tree_reaching_to(const Vert& t, const WM& weight, const Compare& compare = {}) const;
@@ -535,6 +627,37 @@ namespace graph {
 			template <class WM, class Compare = std::less<>, class Combine = std::plus<>>
 			auto parallel_shortest_path(const Vert& s, const Vert& t, const WM& weight,
 				const Compare& compare = {}, const Combine& combine = {}) const -> Path;
+			// Finds the shortest path for each pair of vertices in `queries`
+			template <class Queries, class Weight, class Output, class Compare = std::less<>, class Combine = std::plus<>>
+			void shortest_paths_batch(const Queries& queries, const Weight& weight, Output paths,
+				const Compare& compare = {}, const Combine& combine = {}) const;
+
+			// Ranks vertices by PageRank, gathering along in-edges
+			auto pagerank(double damping = 0.85, double tolerance = 1e-6) const;
+
+			// Orders the vertices topologically in parallel
+			auto parallel_topological_order() const;
+
+			// Finds the strongly connected components in parallel
+			auto scc() const;
+
+			// Finds the core number of each vertex
+			auto core_numbers() const;
+			// Finds the core number of each vertex in parallel
+			auto parallel_core_numbers() const;
+
+			// Precomputes distances to and from `k` landmarks
+			template <class Weight, class Random>
+			auto landmarks(const Weight& weight, std::size_t k, Random& random) const;
+
+			// Computes hub labels for answering distance queries
+			template <class Weight, class Importance = std::nullptr_t, class Compare = std::less<>, class Combine = std::plus<>>
+			auto hub_labels(const Weight& weight, const Importance& importance = nullptr,
+				const Compare& compare = {}, const Combine& combine = {}) const;
+			// Reads hub labels previously written for this graph.
+			template <class D, class Compare = std::less<>, class Combine = std::plus<>>
+			auto hub_labels(std::istream& is,
+				const Compare& compare = {}, const Combine& combine = {}) const;
 		};
 
 		template <class Impl>
@@ -572,12 +695,31 @@ namespace graph {
 
 // Inlines
 #include "dijkstra.inl"
+#include "breadth_first_search.inl"
+#include "traversal.inl"
 #include "random.inl"
 #include "reverse.inl"
 #include "subforest.inl"
-//#include "scc.inl"
+#include "scc.inl"
+#include "connected_components.inl"
+#include "topological_order.inl"
+#include "bellman_ford.inl"
+#include "k_shortest_paths.inl"
+#include "dynamic_shortest_paths.inl"
+#include "minimum_spanning_forest.inl"
+#include "maximum_flow.inl"
+#include "pagerank.inl"
+#include "sparse_matrix.inl"
+#include "triangles.inl"
+#include "cores.inl"
+#include "betweenness.inl"
 #include "floyd_warshall.inl"
+#include "johnson.inl"
+#include "contraction_hierarchy.inl"
+#include "landmarks.inl"
+#include "hub_labels.inl"
 #include "bidirectional_search.inl"
 #include "parallel_bidirectional_search.inl"
+#include "shortest_paths_batch.inl"
 #include "format.inl"
 #include "product.inl"
\ No newline at end of file
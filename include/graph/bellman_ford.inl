@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <utility>
+#include <type_traits>
+
+#include "impl/traits.hpp"
+#include "impl/exceptions.hpp"
+#include "impl/omp.hpp"
+#include "impl/Csr.hpp"
+#include "impl/Subforest.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Lowers `target` to `value` if `value` is better by `compare`, returning whether it did
+			template <class D, class Compare>
+			bool _atomic_improve(std::atomic<D>& target, const D& value, const Compare& compare) {
+				auto current = target.load(std::memory_order_relaxed);
+				while (compare(value, current))
+					if (target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+						return true;
+				return false;
+			}
+
+			// Bellman-Ford with each round relaxing every edge in parallel.  Rounds read the distances left by the previous one, so after `k` rounds each distance is the shortest over paths of at most `k` edges, and a change in round `n` reveals a negative cycle.
+			// Only edges whose tail changed in the previous round can improve anything, and the search stops after the first round which changes nothing.
+			template <class G, class Weight, class Compare, class Combine, class D>
+			std::pair<
+				Subtree<traits::In, G>,
+				Vert_map<G, D>>
+			_bellman_ford(const G& g, Vert<G> s, const Weight& weight,
+				const Compare& compare, const Combine& combine,
+				D zero, D inf) {
+				static_assert(std::is_trivially_copyable_v<D>, "distances are updated atomically");
+				using Verts = traits::Verts<G>;
+				using Edges = traits::Edges<G>;
+				using index_type = typename Dense_index<G>::index_type;
+				Dense_index<G> index(g);
+				auto n = index.size();
+				struct arc {
+					index_type tail, head;
+					D weight;
+				};
+				std::vector<typename Edges::value_type> edges;
+				std::vector<arc> arcs;
+				edges.reserve(static_cast<std::size_t>(Edges::size(g)));
+				arcs.reserve(edges.capacity());
+				for (auto e : Edges::range(g)) {
+					edges.push_back(e);
+					arcs.push_back(arc{ index(Edges::tail(g, e)), index(Edges::head(g, e)), weight(e) });
+				}
+				constexpr auto none = std::numeric_limits<std::size_t>::max();
+				std::vector<std::atomic<D>> distance(n);
+				std::vector<std::atomic<std::size_t>> parent(n);
+				std::vector<D> previous(n, inf);
+				std::vector<unsigned char> active(n, false);
+				auto verts = static_cast<std::ptrdiff_t>(n), size = static_cast<std::ptrdiff_t>(arcs.size());
+				#pragma omp parallel for
+				for (std::ptrdiff_t i = 0; i < verts; ++i) {
+					distance[i].store(inf, std::memory_order_relaxed);
+					parent[i].store(none, std::memory_order_relaxed);
+				}
+				auto source = index(s);
+				distance[source].store(zero, std::memory_order_relaxed);
+				previous[source] = zero;
+				active[source] = true;
+
+				for (std::size_t round = 1;; ++round) {
+					#pragma omp parallel for schedule(static, 4096)
+					for (std::ptrdiff_t k = 0; k < size; ++k) {
+						const auto& a = arcs[k];
+						if (active[a.tail])
+							_atomic_improve(distance[a.head], combine(previous[a.tail], a.weight), compare);
+					}
+					// Any edge which achieved its head's new distance may be its parent, so ties resolve arbitrarily
+					#pragma omp parallel for schedule(static, 4096)
+					for (std::ptrdiff_t k = 0; k < size; ++k) {
+						const auto& a = arcs[k];
+						if (!active[a.tail])
+							continue;
+						auto c = combine(previous[a.tail], a.weight);
+						if (compare(c, previous[a.head]) && !compare(distance[a.head].load(std::memory_order_relaxed), c))
+							parent[a.head].store(static_cast<std::size_t>(k), std::memory_order_relaxed);
+					}
+					bool changed = false;
+					#pragma omp parallel for schedule(static, 4096) reduction(||: changed)
+					for (std::ptrdiff_t i = 0; i < verts; ++i) {
+						auto d = distance[i].load(std::memory_order_relaxed);
+						active[i] = compare(d, previous[i]);
+						previous[i] = d;
+						changed = changed || active[i];
+					}
+					if (!changed)
+						break;
+					if (round >= n)
+						throw precondition_unmet("graph must not contain negative cycles reachable from the source");
+				}
+
+				auto tree = Subtree<traits::In, G>(g, s);
+				auto result = Verts::map(g, inf);
+				for (index_type v = 0; v < n; ++v) {
+					result.assign(index[v], previous[v]);
+					auto k = parent[v].load(std::memory_order_relaxed);
+					if (k != none)
+						tree.insert_edge(edges[k]);
+				}
+				return std::pair(std::move(tree), std::move(result));
+			}
+
+			// Shortest path faster algorithm: Bellman-Ford relaxing only the out-edges of vertices whose distance has changed, taken from a FIFO queue.  A negative cycle shows up as a path to some vertex with `n` or more edges.
+			template <class G, class Weight, class Compare, class Combine, class D>
+			std::pair<
+				Subtree<traits::In, G>,
+				Vert_map<G, D>>
+			_spfa(const G& g, Vert<G> s, const Weight& weight,
+				const Compare& compare, const Combine& combine,
+				D zero, D inf) {
+				using Verts = traits::Verts<G>;
+				using Edges = traits::Edges<G>;
+				auto n = static_cast<std::size_t>(Verts::size(g));
+				auto tree = Subtree<traits::In, G>(g, s);
+				auto distance = Verts::map(g, inf);
+				// Edges in the path by which each vertex was last improved
+				auto hops = Verts::ephemeral_map(g, std::size_t{});
+				auto queued = Verts::ephemeral_map(g, std::uint8_t{});
+				std::deque<Vert<G>> queue{ s };
+				distance.assign(s, zero);
+				queued.assign(s, 1);
+				while (!queue.empty()) {
+					auto v = queue.front();
+					queue.pop_front();
+					queued.assign(v, 0);
+					auto d = distance(v);
+					for (auto e : traits::Out_edges<G>::range(g, v)) {
+						auto u = Edges::head(g, e);
+						auto c = combine(d, weight(e));
+						if (compare(c, distance(u))) {
+							distance.assign(u, c);
+							tree.insert_edge(e); // replace the old edge in the tree
+							hops.assign(u, hops(v) + 1);
+							if (hops(u) >= n)
+								throw precondition_unmet("graph must not contain negative cycles reachable from the source");
+							if (!queued(u)) {
+								queued.assign(u, 1);
+								queue.push_back(u);
+							}
+						}
+					}
+				}
+				return std::pair(std::move(tree), std::move(distance));
+			}
+		}
+		template <class Impl>
+		template <class Weight, class Compare, class Combine>
+		auto Out_edge_graph<Impl>::bellman_ford_shortest_paths_from(const Vert& s, const Weight& weight,
+			const Compare& compare, const Combine& combine) const {
+			// TODO: Convert these to parameters
+			using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
+			auto zero = D{}, inf = std::numeric_limits<D>::max();
+
+			auto [tree, distance] = impl::_bellman_ford(this->_impl(), s, weight, compare, combine, zero, inf);
+			return std::make_pair(_wrap_graph(std::move(tree)), std::move(distance));
+		}
+		template <class Impl>
+		template <class Weight, class Compare, class Combine>
+		auto Out_edge_graph<Impl>::spfa_shortest_paths_from(const Vert& s, const Weight& weight,
+			const Compare& compare, const Combine& combine) const {
+			// TODO: Convert these to parameters
+			using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
+			auto zero = D{}, inf = std::numeric_limits<D>::max();
+
+			auto [tree, distance] = impl::_spfa(this->_impl(), s, weight, compare, combine, zero, inf);
+			return std::make_pair(_wrap_graph(std::move(tree)), std::move(distance));
+		}
+	}
+}
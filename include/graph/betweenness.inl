@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <queue>
+#include <random>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+#include "impl/traits.hpp"
+#include "impl/exceptions.hpp"
+#include "impl/omp.hpp"
+#include "impl/Csr.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Brandes, "A Faster Algorithm for Betweenness Centrality": a search from each source counts the shortest paths to every vertex and then, in reverse order of distance, accumulates the dependency of the source on each vertex from the vertices after it.
+			// Sources are searched in parallel, each thread reusing its own workspace and accumulating into its own centralities, which are summed at the end.  Each dependency is scaled by `scale`.
+			// If `Weight` is `std::nullptr_t`, every edge has unit weight and each search is breadth-first; otherwise it is Dijkstra's algorithm, and weights must be positive so that vertices are settled after every shortest path to them.
+			template <class G, class Weight, class Compare, class Combine, class D>
+			std::vector<double> _brandes(const G& g, const Dense_index<G>& index,
+				const std::vector<typename Dense_index<G>::index_type>& sources, double scale,
+				const Weight& weight, const Compare& compare, const Combine& combine, D zero, D inf) {
+				using index_type = typename Dense_index<G>::index_type;
+				constexpr bool weighted = !std::is_same_v<Weight, std::nullptr_t>;
+				Csr<traits::Out, G> csr(g, index);
+				auto n = index.size();
+				std::vector<D> weights;
+				if constexpr (weighted) {
+					weights.reserve(csr.edges().size());
+					for (const auto& e : csr.edges()) {
+						weights.push_back(weight(e));
+						check_precondition(compare(zero, weights.back()), "edges must have positive weights");
+					}
+				}
+				auto length = [&](std::size_t k) {
+					if constexpr (weighted)
+						return weights[k];
+					else
+						return D(1);
+				};
+				std::vector<double> centrality(n, 0.0);
+				auto size = static_cast<std::ptrdiff_t>(sources.size());
+				#pragma omp parallel
+				{
+					std::vector<double> local(n, 0.0), paths(n, 0.0), dependency(n, 0.0);
+					std::vector<D> distance(n, inf);
+					// Vertices in the order they are settled
+					std::vector<index_type> settled;
+					using pair_type = std::pair<D, index_type>;
+					auto queue_compare = [&](const pair_type& l, const pair_type& r) {
+						// arguments reversed because std::priority_queue is a max queue
+						return compare(r.first, l.first);
+					};
+					std::priority_queue<pair_type, std::vector<pair_type>, decltype(queue_compare)> queue(queue_compare);
+					#pragma omp for schedule(dynamic, 1) nowait
+					for (std::ptrdiff_t i = 0; i < size; ++i) {
+						auto s = sources[i];
+						distance[s] = zero;
+						paths[s] = 1;
+						// Counts the paths through `v` along the edge at `k` to its cokey, returning whether the cokey was reached first
+						auto relax = [&](index_type v, std::size_t k) {
+							auto u = csr.cokey(k);
+							auto c = combine(distance[v], length(k));
+							if (compare(c, distance[u])) {
+								bool first = distance[u] == inf;
+								distance[u] = c;
+								paths[u] = paths[v];
+								return first || weighted;
+							}
+							if (!compare(distance[u], c))
+								paths[u] += paths[v];
+							return false;
+						};
+						if constexpr (weighted) {
+							queue.emplace(zero, s);
+							while (!queue.empty()) {
+								auto [d, v] = queue.top();
+								queue.pop();
+								if (compare(distance[v], d))
+									continue;
+								settled.push_back(v);
+								for (auto k = csr.begin(v); k < csr.end(v); ++k)
+									if (relax(v, k))
+										queue.emplace(distance[csr.cokey(k)], csr.cokey(k));
+							}
+						} else {
+							// The settled vertices double as the queue
+							settled.push_back(s);
+							for (std::size_t head = 0; head < settled.size(); ++head) {
+								auto v = settled[head];
+								for (auto k = csr.begin(v); k < csr.end(v); ++k)
+									if (relax(v, k))
+										settled.push_back(csr.cokey(k));
+							}
+						}
+						// A vertex lies on the shortest paths to each successor it precedes along an edge of the shortest path DAG
+						for (auto it = settled.rbegin(); it != settled.rend(); ++it) {
+							auto v = *it;
+							double sum = 0;
+							for (auto k = csr.begin(v); k < csr.end(v); ++k) {
+								auto u = csr.cokey(k);
+								if (distance[u] != inf && !compare(combine(distance[v], length(k)), distance[u]) && !compare(distance[u], combine(distance[v], length(k))))
+									sum += (1 + dependency[u]) / paths[u];
+							}
+							dependency[v] = paths[v] * sum;
+							if (v != s)
+								local[v] += scale * dependency[v];
+						}
+						for (auto v : settled) {
+							distance[v] = inf;
+							paths[v] = dependency[v] = 0;
+						}
+						settled.clear();
+					}
+					#pragma omp critical
+					for (std::size_t v = 0; v < n; ++v)
+						centrality[v] += local[v];
+				}
+				return centrality;
+			}
+
+			// Betweenness centrality from searches from `sources`, or every vertex if null, as a map
+			template <class G, class Weight, class Compare, class Combine>
+			auto _betweenness_centrality(const G& g, const Dense_index<G>& index,
+				const std::vector<typename Dense_index<G>::index_type>* sources, double scale,
+				const Weight& weight, const Compare& compare, const Combine& combine) {
+				using index_type = typename Dense_index<G>::index_type;
+				std::vector<double> centrality;
+				std::vector<index_type> all;
+				if (!sources) {
+					for (index_type v = 0; v < index.size(); ++v)
+						all.push_back(v);
+					sources = &all;
+				}
+				if constexpr (std::is_same_v<Weight, std::nullptr_t>) {
+					centrality = _brandes(g, index, *sources, scale, weight, std::less<>{}, std::plus<>{},
+						std::size_t{}, std::numeric_limits<std::size_t>::max());
+				} else {
+					// TODO: Convert these to parameters
+					using D = std::decay_t<std::result_of_t<const Weight&(typename traits::Edges<G>::value_type)>>;
+					auto zero = D{}, inf = std::numeric_limits<D>::max();
+					centrality = _brandes(g, index, *sources, scale, weight, compare, combine, zero, inf);
+				}
+				auto result = traits::Verts<G>::map(g, 0.0);
+				for (index_type v = 0; v < index.size(); ++v)
+					result.assign(index[v], centrality[v]);
+				return result;
+			}
+		}
+		template <class Impl>
+		template <class Weight, class Compare, class Combine>
+		auto Out_edge_graph<Impl>::betweenness_centrality(const Weight& weight,
+			const Compare& compare, const Combine& combine) const {
+			const auto& g = this->_impl();
+			impl::Dense_index<Impl> index(g);
+			return impl::_betweenness_centrality(g, index, nullptr, 1.0, weight, compare, combine);
+		}
+		template <class Impl>
+		template <class Random, class Weight, class Compare, class Combine>
+		auto Out_edge_graph<Impl>::approximate_betweenness_centrality(double epsilon, double delta, Random& random,
+			const Weight& weight, const Compare& compare, const Combine& combine) const {
+			using index_type = typename impl::Dense_index<Impl>::index_type;
+			impl::check_precondition(epsilon > 0 && 0 < delta && delta < 1, "epsilon must be positive and delta must be in (0, 1)");
+			const auto& g = this->_impl();
+			impl::Dense_index<Impl> index(g);
+			auto n = index.size();
+			// By Hoeffding's inequality and a union bound over vertices, since each source contributes between zero and n - 2 to each vertex
+			auto samples = static_cast<std::size_t>(std::ceil(std::log(2.0 * std::max<std::size_t>(n, 1) / delta) / (2 * epsilon * epsilon)));
+			if (samples >= n)
+				return impl::_betweenness_centrality(g, index, nullptr, 1.0, weight, compare, combine);
+			std::uniform_int_distribution<std::size_t> source(0, n - 1);
+			std::vector<index_type> sources(samples);
+			for (auto& s : sources)
+				s = static_cast<index_type>(source(random));
+			return impl::_betweenness_centrality(g, index, &sources, double(n) / samples, weight, compare, combine);
+		}
+	}
+}
@@ -7,48 +7,52 @@
 #include <algorithm>
 #include <cassert>
 
-#include <range/v3/algorithm/min.hpp>
-
+#include "impl/traits.hpp"
 #include "impl/exceptions.hpp"
 
 namespace graph {
 	inline namespace v1 {
 		namespace impl {
+			// Settles the nearest vertex in one direction of a bidirectional search.  Whenever an edge reaches a vertex labelled by the other direction, the path through it is a candidate for the shortest, and the best is kept in `best` and `meet`.
 			template <class Adjacency, class G, class Queue,
-				class Near, class Far,
-				class Weight, class Distance, class Tree,
-				class Compare, class Combine>
-			bool _bidirectional_search_step(const G& g, Queue& queue,
-				Near& near, const Far& far,
-				const Weight& weight, Distance& distance, Tree& tree,
-				const Compare& compare, const Combine& combine) {
+				class Closed, class Weight, class Distance, class Far_distance, class Tree,
+				class Compare, class Combine, class D>
+			void _bidirectional_search_step(const G& g, Queue& queue, Closed& closed,
+				const Weight& weight, Distance& distance, const Far_distance& far_distance, Tree& tree,
+				const Compare& compare, const Combine& combine,
+				D inf, D& best, Vert<G>& meet) {
 				auto [d, v] = queue.top();
 				queue.pop();
-				if (near.insert(v)) {
-					if (far.contains(v))
-						return true;
-					for (auto e : traits::Adjacent_edges<Adjacency, G>::range(g, v)) {
-						auto u = traits::adjacency_cokey<Adjacency, G>(g, e);
+				if (!closed.insert(v))
+					return;
+				for (auto e : traits::Adjacent_edges<Adjacency, G>::range(g, v)) {
+					auto u = traits::adjacency_cokey<Adjacency, G>(g, e);
 #ifdef NDEBUG
-						// optimization not required for correctness but skips checks below
-						if (near.contains(u))
-							continue;
+					// optimization not required for correctness but skips checks below
+					if (closed.contains(u))
+						continue;
 #endif
-						auto c = combine(d, weight(e));
+					auto c = combine(d, weight(e));
 #ifndef NDEBUG
-						if (compare(c, d))
-							throw precondition_unmet("negative weight edge");
+					if (compare(c, d))
+						throw precondition_unmet("negative weight edge");
 #endif
-						decltype(auto) du = distance[u];
-						if (compare(c, du)) {
-							assert(!near.contains(u)); // sanity check which should never fail
-							du = c;
-							tree.insert_edge(e); // replace the old edge in the tree
-							queue.emplace(c, u);
+					decltype(auto) du = distance[u];
+					if (compare(c, du)) {
+						assert(!closed.contains(u)); // sanity check which should never fail
+						du = c;
+						tree.insert_edge(e); // replace the old edge in the tree
+						queue.emplace(c, u);
+						auto far = far_distance(u);
+						if (far != inf) {
+							auto total = combine(c, far);
+							if (compare(total, best)) {
+								best = total;
+								meet = u;
+							}
 						}
 					}
 				}
-				return false;
 			}
 		}
 		template <class Impl>
@@ -78,42 +82,43 @@ namespace graph {
 			s_queue.emplace(s_distance[s] = zero, s);
 			t_queue.emplace(t_distance[t] = zero, t);
 
-			bool done = false;
+			// Length of the shortest path found so far, and the vertex where its halves meet
+			auto best = inf;
+			auto meet = this->null_vert();
+			if (s == t) {
+				best = zero;
+				meet = s;
+			}
 			auto expand_s = [&] {
-				done = impl::_bidirectional_search_step<impl::traits::Out>(this->_impl(), s_queue,
-					s_closed, t_closed, weight, s_distance, s_tree, compare, combine);
+				impl::_bidirectional_search_step<impl::traits::Out>(this->_impl(), s_queue, s_closed,
+					weight, s_distance, t_distance, s_tree, compare, combine, inf, best, meet);
 			};
 			auto expand_t = [&] {
-				done = impl::_bidirectional_search_step<impl::traits::In>(this->_impl(), t_queue,
-					t_closed, s_closed, weight, t_distance, t_tree, compare, combine);
+				impl::_bidirectional_search_step<impl::traits::In>(this->_impl(), t_queue, t_closed,
+					weight, t_distance, s_distance, t_tree, compare, combine, inf, best, meet);
+			};
+			// Any shorter path would have to pass through vertices beyond both frontiers, so the search stops once their distances together reach the best found.
+			// If either side runs out, it has labelled everything it can reach, including wherever the halves of a shortest path meet.
+			auto done = [&] {
+				if (s_queue.empty() || t_queue.empty())
+					return true;
+				return best != inf && !compare(combine(s_queue.top().first, t_queue.top().first), best);
 			};
 
-			// Interleave bidirectional search steps
-			expand_s();
-			expand_t();
-			while (!done) {
-				if (t_queue.size() < s_queue.size()) {
-					if (t_queue.empty())
-						return this->null_path();
+			// Interleave bidirectional search steps, expanding the smaller frontier
+			while (!done()) {
+				if (t_queue.size() < s_queue.size())
 					expand_t();
-				} else {
-					if (s_queue.empty())
-						return this->null_path();
+				else
 					expand_s();
-				}
 			}
-
-			// Find the minimal rendezvous
-			auto total_distance = [&](auto v) { return combine(s_distance(v), t_distance(v)); };
-			auto rendezvous = ranges::min({
-				ranges::min(s_closed, compare, total_distance),
-				ranges::min(t_closed, compare, total_distance)},
-				compare, total_distance);
+			if (this->is_null(meet))
+				return this->null_path();
 
 			// Construct path from trees
 			return this->concatenate_paths(
-				s_tree.path_from_root_to(rendezvous),
-				t_tree.path_to_root_from(rendezvous));
+				s_tree.path_from_root_to(meet),
+				t_tree.path_to_root_from(meet));
 		}
 	}
 }
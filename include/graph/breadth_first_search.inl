@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "impl/traits.hpp"
+#include "impl/omp.hpp"
+#include "impl/Csr.hpp"
+#include "impl/Atomic_bitmap.hpp"
+#include "impl/Subforest.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Level-synchronous parallel breadth-first search, returning the depth of each vertex and the edge by which it was reached, both by dense index.  The graph is only read, so its adjacencies are traversed directly rather than copied into a snapshot.
+			// If `Bidirectional`, levels whose frontier has more out-edges than the unvisited vertices have in-edges are expanded bottom-up, with each unvisited vertex looking for a parent in the frontier (Beamer et al., "Direction-Optimizing Breadth-First Search").
+			template <bool Bidirectional, class G>
+			auto _breadth_first_search(const G& g, const Dense_index<G>& index, typename Dense_index<G>::index_type s) {
+				using Edges = traits::Edges<G>;
+				using Out_edges = traits::Out_edges<G>;
+				using index_type = typename Dense_index<G>::index_type;
+				using Edge = typename Edges::value_type;
+				// Heuristic parameters suggested by Beamer et al.
+				constexpr std::size_t alpha = 14, beta = 24;
+				auto inf = std::numeric_limits<std::size_t>::max();
+				auto n = index.size();
+				std::vector<std::size_t> depth(n, inf);
+				std::vector<Edge> parent(n, Edges::null(g));
+				Atomic_bitmap visited(n), frontier_set(n), next_set(n);
+				std::vector<index_type> frontier{ s }, next;
+				visited.insert(s);
+				depth[s] = 0;
+				// Out-edges of unvisited vertices, which bounds the work of a bottom-up step
+				auto out_degree = [&](index_type v) {
+					return static_cast<std::size_t>(Out_edges::size(g, index[v]));
+				};
+				auto unexplored = static_cast<std::size_t>(Edges::size(g)) - out_degree(s);
+				auto top_down_step = [&](std::size_t level) {
+					auto size = static_cast<std::ptrdiff_t>(frontier.size());
+					#pragma omp parallel
+					{
+						std::vector<index_type> local;
+						#pragma omp for schedule(dynamic, 64) nowait
+						for (std::ptrdiff_t i = 0; i < size; ++i) {
+							auto v = frontier[i];
+							for (auto e : Out_edges::range(g, index[v])) {
+								auto u = index(Edges::head(g, e));
+								if (visited.insert(u)) {
+									depth[u] = level;
+									parent[u] = e;
+									local.push_back(u);
+								}
+							}
+						}
+						#pragma omp critical
+						next.insert(next.end(), local.begin(), local.end());
+					}
+				};
+				// Generic so that it is only instantiated for graphs with in-edges
+				auto bottom_up_step = [&](std::size_t level, auto in_edges) {
+					using In_edges = decltype(in_edges);
+					frontier_set.clear();
+					for (auto v : frontier)
+						frontier_set.insert(v);
+					next_set.clear();
+					auto verts = static_cast<std::ptrdiff_t>(n);
+					#pragma omp parallel for schedule(dynamic, 1024)
+					for (std::ptrdiff_t i = 0; i < verts; ++i) {
+						auto v = static_cast<index_type>(i);
+						if (visited.contains(v))
+							continue;
+						for (auto e : In_edges::range(g, index[v])) {
+							if (frontier_set.contains(index(Edges::tail(g, e)))) {
+								// Only this thread considers `v`, so it need not compete for it
+								visited.insert(v);
+								next_set.insert(v);
+								depth[v] = level;
+								parent[v] = e;
+								break;
+							}
+						}
+					}
+					for (index_type v = 0; v < n; ++v)
+						if (next_set.contains(v))
+							next.push_back(v);
+				};
+
+				bool bottom_up = false;
+				for (std::size_t level = 1; !frontier.empty(); ++level) {
+					auto frontier_edges = std::size_t{};
+					for (auto v : frontier)
+						frontier_edges += out_degree(v);
+					next.clear();
+					if constexpr (!Bidirectional) {
+						top_down_step(level);
+					} else {
+						if (!bottom_up && frontier_edges > unexplored / alpha)
+							bottom_up = true;
+						else if (bottom_up && frontier.size() < n / beta)
+							bottom_up = false;
+						if (bottom_up)
+							bottom_up_step(level, traits::In_edges<G>{});
+						else
+							top_down_step(level);
+					}
+					unexplored -= std::min(unexplored, frontier_edges);
+					std::swap(frontier, next);
+				}
+				return std::pair(std::move(parent), std::move(depth));
+			}
+		}
+		template <class Impl>
+		auto Out_edge_graph<Impl>::breadth_first_search_from(const Vert& s) const {
+			const auto& g = this->_impl();
+			impl::Dense_index<Impl> index(g);
+			auto [parent, depth] = impl::_breadth_first_search<impl::traits::has_in_edges<Impl>>(g, index, index(s));
+
+			// Copy the results out of the dense arrays
+			auto tree = this->in_subtree(s);
+			auto hops = this->vert_map(std::numeric_limits<std::size_t>::max());
+			for (std::size_t i = 0; i < index.size(); ++i) {
+				auto v = index[static_cast<typename impl::Dense_index<Impl>::index_type>(i)];
+				hops.assign(v, depth[i]);
+				if (!this->is_null(parent[i]))
+					tree.insert_edge(parent[i]);
+			}
+			return std::make_pair(std::move(tree), std::move(hops));
+		}
+	}
+}
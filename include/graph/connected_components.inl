@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#include "impl/traits.hpp"
+#include "impl/omp.hpp"
+#include "impl/Csr.hpp"
+#include "impl/Union_find.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Connected components ignoring the direction of edges, by uniting the endpoints of every edge in parallel.
+			// Following Sutton et al., "Optimizing Parallel Graph Connectivity Computation via Subgraph Sampling", a sample of edges is united first, which usually joins most of the largest component, and afterwards edges inside the largest component are skipped without being united.
+			template <class G>
+			auto _connected_components(const G& g) {
+				using Verts = traits::Verts<G>;
+				using Edges = traits::Edges<G>;
+				using index_type = typename Dense_index<G>::index_type;
+				Dense_index<G> index(g);
+				auto n = index.size();
+				std::vector<std::pair<index_type, index_type>> arcs;
+				arcs.reserve(static_cast<std::size_t>(Edges::size(g)));
+				for (auto e : Edges::range(g))
+					arcs.emplace_back(index(Edges::tail(g, e)), index(Edges::head(g, e)));
+				auto m = static_cast<std::ptrdiff_t>(arcs.size());
+
+				Union_find<index_type> sets(n);
+				// About two sampled edges per vertex
+				auto stride = static_cast<std::ptrdiff_t>(std::max<std::size_t>(1, arcs.size() / std::max<std::size_t>(1, 2 * n)));
+				#pragma omp parallel for schedule(static, 4096)
+				for (std::ptrdiff_t i = 0; i < m; i += stride)
+					sets.unite(arcs[i].first, arcs[i].second);
+				sets.compress();
+
+				// Estimate the largest component from the roots of evenly spaced vertices
+				auto largest = Dense_index<G>::null_index;
+				if (n > 0) {
+					std::vector<index_type> roots;
+					std::size_t samples = std::min<std::size_t>(n, 1024);
+					for (std::size_t i = 0; i < samples; ++i)
+						roots.push_back(sets.parent(static_cast<index_type>(i * n / samples)));
+					std::sort(roots.begin(), roots.end());
+					std::size_t best = 0;
+					for (std::size_t i = 0, j; i < roots.size(); i = j) {
+						for (j = i; j < roots.size() && roots[j] == roots[i]; ++j)
+							;
+						if (j - i > best) {
+							best = j - i;
+							largest = roots[i];
+						}
+					}
+				}
+
+				#pragma omp parallel for schedule(static, 4096)
+				for (std::ptrdiff_t i = 0; i < m; ++i) {
+					if (i % stride == 0)
+						continue;
+					auto [u, v] = arcs[i];
+					// Both ends were already joined, even if the largest component has since been united with another
+					if (sets.parent(u) == largest && sets.parent(v) == largest)
+						continue;
+					sets.unite(u, v);
+				}
+				sets.compress();
+
+				// Number components consecutively
+				std::vector<std::size_t> id(n, std::numeric_limits<std::size_t>::max());
+				std::size_t count = 0;
+				auto components = Verts::map(g, std::size_t{});
+				for (index_type v = 0; v < n; ++v) {
+					auto& c = id[sets.parent(v)];
+					if (c == std::numeric_limits<std::size_t>::max())
+						c = count++;
+					components.assign(index[v], c);
+				}
+				return std::pair(std::move(components), count);
+			}
+		}
+		template <class Impl>
+		auto Graph<Impl>::connected_components() const {
+			return impl::_connected_components(this->_impl());
+		}
+	}
+}
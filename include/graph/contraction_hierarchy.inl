@@ -0,0 +1,22 @@
+#pragma once
+
+#include <limits>
+#include <functional>
+
+#include "impl/Contraction_hierarchy.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		template <class Impl>
+		template <class Weight, class Compare, class Combine>
+		auto Graph<Impl>::contraction_hierarchy(const Weight& weight,
+			const Compare& compare, const Combine& combine) const {
+			// TODO: Convert these to parameters
+			using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
+			auto zero = D{}, inf = std::numeric_limits<D>::max();
+
+			return impl::Contraction_hierarchy<Impl, D, Compare, Combine>(
+				this->_impl(), weight, compare, combine, zero, inf);
+		}
+	}
+}
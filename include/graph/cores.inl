@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <atomic>
+#include <utility>
+
+#include "impl/traits.hpp"
+#include "impl/omp.hpp"
+#include "impl/Csr.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Calls `visit` with the index of the other end of each edge into or out of `v`, skipping loops.  Parallel edges are visited once each.
+			template <class G, class Visit>
+			void _for_each_neighbor(const G& g, const Dense_index<G>& index, typename Dense_index<G>::index_type v, const Visit& visit) {
+				using Edges = traits::Edges<G>;
+				for (auto e : traits::Out_edges<G>::range(g, index[v])) {
+					auto u = index(Edges::head(g, e));
+					if (u != v)
+						visit(u);
+				}
+				for (auto e : traits::In_edges<G>::range(g, index[v])) {
+					auto u = index(Edges::tail(g, e));
+					if (u != v)
+						visit(u);
+				}
+			}
+
+			// Degree of each vertex ignoring the direction of edges, from its in- and out-degrees less twice its loops
+			template <class G>
+			auto _undirected_degrees(const G& g, const Dense_index<G>& index) {
+				using Edges = traits::Edges<G>;
+				auto n = static_cast<std::ptrdiff_t>(index.size());
+				std::vector<std::size_t> degree(index.size());
+				#pragma omp parallel for schedule(dynamic, 1024)
+				for (std::ptrdiff_t i = 0; i < n; ++i) {
+					auto v = index[static_cast<typename Dense_index<G>::index_type>(i)];
+					auto d = static_cast<std::size_t>(traits::Out_edges<G>::size(g, v)) +
+						static_cast<std::size_t>(traits::In_edges<G>::size(g, v));
+					for (auto e : traits::Out_edges<G>::range(g, v))
+						if (Edges::head(g, e) == v)
+							d -= 2;
+					degree[i] = d;
+				}
+				return degree;
+			}
+
+			// Batagelj and Zaversnik, "An O(m) Algorithm for Cores Decomposition of Networks": vertices are kept sorted by remaining degree in buckets, and removing the vertex of least degree moves each of its remaining neighbors down one bucket in constant time.
+			template <class G>
+			auto _core_numbers(const G& g) {
+				using Verts = traits::Verts<G>;
+				using index_type = typename Dense_index<G>::index_type;
+				Dense_index<G> index(g);
+				auto n = index.size();
+				auto degree = _undirected_degrees(g, index);
+				std::size_t max_degree = 0;
+				for (auto d : degree)
+					max_degree = std::max(max_degree, d);
+				// Vertices sorted by degree, the position of each vertex, and the start of each bucket
+				std::vector<index_type> sorted(n);
+				std::vector<std::size_t> position(n), start(max_degree + 2, 0);
+				for (auto d : degree)
+					++start[d + 1];
+				for (std::size_t d = 0; d <= max_degree; ++d)
+					start[d + 1] += start[d];
+				{
+					auto next = start;
+					for (index_type v = 0; v < n; ++v) {
+						position[v] = next[degree[v]]++;
+						sorted[position[v]] = v;
+					}
+				}
+				for (std::size_t i = 0; i < n; ++i) {
+					auto v = sorted[i];
+					_for_each_neighbor(g, index, v, [&](index_type u) {
+						auto du = degree[u];
+						if (du <= degree[v])
+							return;
+						// Swap `u` with the first vertex of its bucket, then shrink the bucket past it
+						auto pu = position[u], pw = start[du];
+						auto w = sorted[pw];
+						if (u != w) {
+							std::swap(sorted[pu], sorted[pw]);
+							position[u] = pw;
+							position[w] = pu;
+						}
+						++start[du];
+						--degree[u];
+					});
+				}
+				auto cores = Verts::map(g, std::size_t{});
+				for (index_type v = 0; v < n; ++v)
+					cores.assign(index[v], degree[v]);
+				return cores;
+			}
+
+			// Level-synchronous peeling: at each level `k`, every remaining vertex of degree at most `k` is removed at once, their neighbors' degrees are decremented atomically, and those which fall to `k` are removed next, until none remain at that level.
+			template <class G>
+			auto _parallel_core_numbers(const G& g) {
+				using Verts = traits::Verts<G>;
+				using index_type = typename Dense_index<G>::index_type;
+				constexpr auto none = std::numeric_limits<std::size_t>::max();
+				Dense_index<G> index(g);
+				auto n = static_cast<std::ptrdiff_t>(index.size());
+				auto initial = _undirected_degrees(g, index);
+				std::vector<std::atomic<std::size_t>> degree(index.size());
+				std::vector<std::size_t> core(index.size(), none);
+				#pragma omp parallel for schedule(static, 4096)
+				for (std::ptrdiff_t i = 0; i < n; ++i)
+					degree[i].store(initial[i], std::memory_order_relaxed);
+
+				std::vector<index_type> frontier, next;
+				std::size_t removed = 0;
+				for (std::size_t k = 0; removed < index.size(); ++k) {
+					frontier.clear();
+					#pragma omp parallel
+					{
+						std::vector<index_type> local;
+						#pragma omp for schedule(static, 4096) nowait
+						for (std::ptrdiff_t i = 0; i < n; ++i)
+							if (core[i] == none && degree[i].load(std::memory_order_relaxed) <= k)
+								local.push_back(static_cast<index_type>(i));
+						#pragma omp critical
+						frontier.insert(frontier.end(), local.begin(), local.end());
+					}
+					while (!frontier.empty()) {
+						removed += frontier.size();
+						for (auto v : frontier)
+							core[v] = k;
+						next.clear();
+						auto size = static_cast<std::ptrdiff_t>(frontier.size());
+						#pragma omp parallel
+						{
+							std::vector<index_type> local;
+							#pragma omp for schedule(dynamic, 64) nowait
+							for (std::ptrdiff_t i = 0; i < size; ++i) {
+								_for_each_neighbor(g, index, frontier[i], [&](index_type u) {
+									if (core[u] != none)
+										return;
+									// Exactly one decrement takes a vertex from above `k` to `k`
+									if (degree[u].fetch_sub(1, std::memory_order_relaxed) == k + 1)
+										local.push_back(u);
+								});
+							}
+							#pragma omp critical
+							next.insert(next.end(), local.begin(), local.end());
+						}
+						std::swap(frontier, next);
+					}
+				}
+				auto cores = Verts::map(g, std::size_t{});
+				for (std::ptrdiff_t i = 0; i < n; ++i)
+					cores.assign(index[static_cast<index_type>(i)], core[i]);
+				return cores;
+			}
+		}
+		template <class Impl>
+		auto Bi_edge_graph<Impl>::core_numbers() const {
+			return impl::_core_numbers(this->_impl());
+		}
+		template <class Impl>
+		auto Bi_edge_graph<Impl>::parallel_core_numbers() const {
+			return impl::_parallel_core_numbers(this->_impl());
+		}
+	}
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <limits>
+#include <functional>
+#include <queue>
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+#include "impl/traits.hpp"
+#include "impl/exceptions.hpp"
+#include "impl/Subforest.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Shortest paths from a fixed source, kept up to date as edges are inserted and their weights decreased.
+			// Distances only ever fall, so an update relaxes the changed edges and continues Dijkstra's algorithm from just the vertices they improve, taking time proportional to the region whose distances change rather than the whole graph.
+			// Unlike most results in this library, the tree and distances are persistent and follow the graph as it grows.  Erasing edges or increasing weights invalidates them.
+			template <class G, class Weight, class Compare, class Combine, class D>
+			class Dynamic_shortest_paths {
+				using Verts = traits::Verts<G>;
+				using Edges = traits::Edges<G>;
+			public:
+				using Vert = typename Verts::value_type;
+				using Edge = typename Edges::value_type;
+
+				// `weight` is held by reference so that decreases made through it are seen by `update`
+				Dynamic_shortest_paths(const G& g, const Vert& s, const Weight& weight,
+					const Compare& compare, const Combine& combine, D zero, D inf) :
+					Dynamic_shortest_paths(g, weight, compare, combine, inf,
+						_dijkstra<traits::Out>(g, s, weight, compare, combine, zero, inf)) {
+				}
+
+				const Vert& source() const {
+					return _source;
+				}
+				// Length of the shortest path from the source to `v`, or infinity if there is none
+				D distance(const Vert& v) const {
+					return _distance(v);
+				}
+				const auto& distances() const {
+					return _distance;
+				}
+				// Tree of shortest paths from the source
+				const auto& tree() const {
+					return _tree;
+				}
+				// Shortest path from the source to `v`, or a null path if there is none
+				Path<G> shortest_path(const Vert& v) const {
+					return _tree.path_from_root_to(v);
+				}
+
+				// Updates the paths after `e` has been inserted or had its weight decreased
+				void update(const Edge& e) {
+					_relax(e);
+					_propagate();
+				}
+				// Updates the paths after each of `edges` has been inserted or had its weight decreased, propagating their effects together
+				template <class Range>
+				void update(const Range& edges) {
+					for (const auto& e : edges)
+						_relax(e);
+					_propagate();
+				}
+
+			private:
+				using _pair_type = std::pair<D, Vert>;
+				struct _queue_compare {
+					Compare compare;
+					bool operator()(const _pair_type& l, const _pair_type& r) const {
+						// arguments reversed because std::priority_queue is a max queue
+						return compare(r.first, l.first);
+					}
+				};
+				template <class Tree, class Distance>
+				Dynamic_shortest_paths(const G& g, const Weight& weight,
+					const Compare& compare, const Combine& combine, D inf,
+					std::pair<Tree, Distance>&& paths) :
+					_g(g), _weight(weight), _compare(compare), _combine(combine), _inf(inf),
+					_source(paths.first.root()),
+					_tree(_wrap_graph(std::move(paths.first))),
+					_distance(std::move(paths.second)),
+					_queue(_queue_compare{ compare }) {
+				}
+
+				// Lowers the distance to the head of `e` if it gives a shorter path, queuing the head to pass it on
+				void _relax(const Edge& e) {
+					const G& g = _g;
+					auto d = _distance(Edges::tail(g, e));
+					if (d == _inf)
+						return;
+					auto c = _combine(d, _weight(e));
+					check_precondition(!_compare(c, d), "edges must have non-negative weights");
+					auto v = Edges::head(g, e);
+					if (_compare(c, _distance(v))) {
+						_distance.assign(v, c);
+						_tree._impl().insert_edge(e); // replace the old edge in the tree
+						_queue.emplace(c, v);
+					}
+				}
+				// Dijkstra's algorithm from the queued vertices, whose distances are already as low as the changes make them
+				void _propagate() {
+					const G& g = _g;
+					while (!_queue.empty()) {
+						auto [d, v] = _queue.top();
+						_queue.pop();
+						if (_compare(_distance(v), d))
+							continue; // stale entry
+						for (auto e : traits::Out_edges<G>::range(g, v))
+							_relax(e);
+					}
+				}
+
+				std::reference_wrapper<const G> _g;
+				const Weight& _weight;
+				Compare _compare;
+				Combine _combine;
+				D _inf;
+				Vert _source;
+				decltype(_wrap_graph(std::declval<Subtree<traits::In, G>>())) _tree;
+				typename Verts::template map_type<D> _distance;
+				std::priority_queue<_pair_type, std::vector<_pair_type>, _queue_compare> _queue;
+			};
+		}
+		template <class Impl>
+		template <class Weight, class Compare, class Combine>
+		auto Out_edge_graph<Impl>::dynamic_shortest_paths_from(const Vert& s, const Weight& weight,
+			const Compare& compare, const Combine& combine) const {
+			// TODO: Convert these to parameters
+			using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
+			auto zero = D{}, inf = std::numeric_limits<D>::max();
+
+			return impl::Dynamic_shortest_paths<Impl, Weight, Compare, Combine, D>(this->_impl(), s, weight, compare, combine, zero, inf);
+		}
+	}
+}
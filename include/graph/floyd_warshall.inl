@@ -2,13 +2,79 @@
 
 #include <limits>
 #include <functional>
+#include <algorithm>
+#include <cstddef>
 #include <cassert>
 
 #include "impl/exceptions.hpp"
-#include "impl/Subforest.hpp"
+#include "impl/omp.hpp"
+#include "impl/Vert_matrix.hpp"
+#include "impl/Predecessor_matrix.hpp"
 
 namespace graph {
 	inline namespace v1 {
+		namespace impl {
+			// Relaxes the rows `[i0, i1)` and columns `[j0, j1)` of a row-major matrix through the intermediates `[k0, k1)`, updating the matching predecessors `p` alongside.
+			// Iterating over intermediates outermost keeps this correct when the block being updated also supplies them.
+			template <class D, class P, class Compare, class Combine>
+			void _min_plus_block(D* m, P* p, std::size_t n,
+				std::size_t i0, std::size_t i1, std::size_t j0, std::size_t j1,
+				std::size_t k0, std::size_t k1,
+				const Compare& compare, const Combine& combine, const D inf) {
+				for (auto k = k0; k < k1; ++k) {
+					const D* mk = m + k * n;
+					const P* pk = p + k * n;
+					for (auto i = i0; i < i1; ++i) {
+						D* mi = m + i * n;
+						P* pi = p + i * n;
+						const D mik = mi[k];
+						if (!compare(mik, inf))
+							continue;
+						// Branch-free so that the compiler can vectorize it, and never combining with infinity so that integers cannot overflow
+						for (auto j = j0; j < j1; ++j) {
+							D b = mk[j], a = mi[j];
+							// The path through `k` ends in the same edge as the path from `k`
+							P q = pk[j], r = pi[j];
+							bool finite = compare(b, inf);
+							D c = combine(mik, finite ? b : D{});
+							bool shorter = finite && compare(c, a);
+							mi[j] = shorter ? c : a;
+							pi[j] = shorter ? q : r;
+						}
+					}
+				}
+			}
+
+			// Blocked Floyd-Warshall: each round first closes the diagonal block, then the blocks sharing its rows or columns, and finally all other blocks, which are independent of one another.
+			template <class D, class P, class Compare, class Combine>
+			void _floyd_warshall(D* m, P* p, std::size_t n,
+				const Compare& compare, const Combine& combine, const D& inf) {
+				// Three blocks of this size fit comfortably in a typical L2 cache
+				constexpr std::size_t block = 64;
+				auto blocks = static_cast<std::ptrdiff_t>((n + block - 1) / block);
+				auto begin = [](std::ptrdiff_t b) { return std::size_t(b) * block; };
+				auto end = [n](std::ptrdiff_t b) { return std::min(n, std::size_t(b + 1) * block); };
+				for (std::ptrdiff_t kb = 0; kb < blocks; ++kb) {
+					auto k0 = begin(kb), k1 = end(kb);
+					_min_plus_block(m, p, n, k0, k1, k0, k1, k0, k1, compare, combine, inf);
+					#pragma omp parallel for schedule(dynamic, 1)
+					for (std::ptrdiff_t b = 0; b < blocks; ++b) {
+						if (b == kb)
+							continue;
+						_min_plus_block(m, p, n, k0, k1, begin(b), end(b), k0, k1, compare, combine, inf);
+						_min_plus_block(m, p, n, begin(b), end(b), k0, k1, k0, k1, compare, combine, inf);
+					}
+					#pragma omp parallel for collapse(2) schedule(dynamic, 1)
+					for (std::ptrdiff_t ib = 0; ib < blocks; ++ib) {
+						for (std::ptrdiff_t jb = 0; jb < blocks; ++jb) {
+							if (ib == kb || jb == kb)
+								continue;
+							_min_plus_block(m, p, n, begin(ib), end(ib), begin(jb), end(jb), k0, k1, compare, combine, inf);
+						}
+					}
+				}
+			}
+		}
 		template <class Impl>
 		template <class Weight, class Compare, class Combine>
 		auto Graph<Impl>::all_pairs_shortest_paths(const Weight& weight,
@@ -17,44 +83,30 @@ namespace graph {
 			using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
 			auto zero = D{}, inf = std::numeric_limits<D>::max();
 
-			// Build distance map
-			auto distance = vert_map(vert_map(inf));
-			for (auto v : verts())
-				distance[v][v] = zero;
-			for (auto e : edges()) {
-				decltype(auto) d = distance[tail(e)][head(e)];
-				d = std::min({d, weight(e)}, compare);
-			}
-			for (auto v : verts()) {
-				decltype(auto) dv_ = distance(v);
-				for (auto s : verts()) {
-					decltype(auto) ds_ = distance[s];
-					for (auto t : verts()) {
-						decltype(auto) d = ds_[t];
-						d = std::min({d, combine(ds_(v), dv_(t))}, compare);
-					}
+			// Build distance and predecessor matrices
+			using Predecessors = impl::Predecessor_matrix<Impl>;
+			auto distance = impl::Vert_matrix<Impl, D>(this->_impl(), inf);
+			auto predecessors = Predecessors(this->_impl());
+			// Both matrices number the vertices in the same order
+			const auto& index = distance.index();
+			const auto& edges = predecessors.edges();
+			auto n = distance.order();
+			D* m = distance.data();
+			auto* p = predecessors.data();
+			for (std::size_t i = 0; i < n; ++i)
+				m[i * n + i] = zero;
+			for (std::size_t k = 0; k < edges.size(); ++k) {
+				const auto& e = edges[k];
+				auto ij = std::size_t(index(tail(e))) * n + index(head(e));
+				auto w = weight(e);
+				if (compare(w, m[ij])) {
+					m[ij] = w;
+					p[ij] = static_cast<typename Predecessors::index_type>(k);
 				}
 			}
+			impl::_floyd_warshall(m, p, n, compare, combine, inf);
 
-			// Build trees from distance map
-			auto trees = vert_map(null_in_subtree());
-			for (auto s : verts()) {
-				decltype(auto) ds_ = distance(s);
-				auto tree = in_subtree(s);
-				for (auto e_prime : edges()) {
-					auto v = tail(e_prime), t = head(e_prime);
-					if (t == s || !compare(ds_(t), inf))
-						continue;
-					auto d_prime = combine(ds_(v), weight(e_prime));
-					auto e = tree.in_edge_or_null(t);
-					if (is_null(e) || compare(d_prime,
-						combine(ds_(tail(e)), weight(e))))
-						tree.insert_edge(e_prime);
-				}
-				trees.assign(s, std::move(tree));
-			}
-			
-			return std::pair(std::move(trees), std::move(distance));
+			return std::pair(std::move(predecessors), std::move(distance));
 		}
 	}
 }
@@ -8,14 +8,10 @@
 #include <stdexcept>
 #include <type_traits>
 
+#include "impl/exceptions.hpp"
+
 namespace graph {
 	inline namespace v1 {
-		struct format_error : std::runtime_error {
-			using _base_type = std::runtime_error;
-			format_error(std::initializer_list<const char *> expected, std::string found) :
-				_base_type(std::string("expected ") + *expected.begin() + ", found: " + found)
-			{}
-		};
 		namespace impl {
 			// Allow specification of vertex and edge attributes using a named argument-like syntax:
 			// `g.dot_format(vert_attribute_name{"name"} = map, ...)`
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <limits>
+#include <functional>
+#include <istream>
+
+#include "impl/Hub_labels.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		template <class Impl>
+		template <class Weight, class Importance, class Compare, class Combine>
+		auto Bi_edge_graph<Impl>::hub_labels(const Weight& weight, const Importance& importance,
+			const Compare& compare, const Combine& combine) const {
+			// TODO: Convert these to parameters
+			using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
+			auto zero = D{}, inf = std::numeric_limits<D>::max();
+			return impl::Hub_labels<Impl, D, Compare, Combine>(
+				this->_impl(), weight, importance, compare, combine, zero, inf);
+		}
+		template <class Impl>
+		template <class D, class Compare, class Combine>
+		auto Bi_edge_graph<Impl>::hub_labels(std::istream& is,
+			const Compare& compare, const Combine& combine) const {
+			// TODO: Convert these to parameters
+			auto zero = D{}, inf = std::numeric_limits<D>::max();
+			return impl::Hub_labels<Impl, D, Compare, Combine>(
+				this->_impl(), is, compare, combine, zero, inf);
+		}
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <atomic>
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Set of dense indices into which threads may insert concurrently
+			class Atomic_bitmap {
+			public:
+				explicit Atomic_bitmap(std::size_t size) :
+					_words((size + 63) / 64) {
+				}
+				bool contains(std::size_t i) const {
+					return _words[i / 64].load(std::memory_order_relaxed) & _bit(i);
+				}
+				// Returns whether `i` was not already present
+				bool insert(std::size_t i) {
+					auto bit = _bit(i);
+					// Reading first avoids taking the cache line exclusively when most insertions fail
+					if (_words[i / 64].load(std::memory_order_relaxed) & bit)
+						return false;
+					return !(_words[i / 64].fetch_or(bit, std::memory_order_relaxed) & bit);
+				}
+				void erase(std::size_t i) {
+					_words[i / 64].fetch_and(~_bit(i), std::memory_order_relaxed);
+				}
+				// Not safe to call concurrently with insertions
+				void clear() {
+					for (auto& word : _words)
+						word.store(0, std::memory_order_relaxed);
+				}
+			private:
+				static std::uint64_t _bit(std::size_t i) {
+					return std::uint64_t(1) << (i % 64);
+				}
+				std::vector<std::atomic<std::uint64_t>> _words;
+			};
+		}
+	}
+}
@@ -0,0 +1,461 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+#include <utility>
+
+#include "traits.hpp"
+#include "exceptions.hpp"
+#include "omp.hpp"
+#include "Path.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Shortest path index built by contracting vertices in order of increasing importance.  Contracting a vertex removes it and inserts shortcut arcs between its neighbors wherever it lay on the only shortest path between them.  Queries then only relax arcs towards more important vertices, so they settle a tiny fraction of the graph.
+			// Preprocessing is fastest on graphs with a natural hierarchy, such as road networks; graphs without one develop a dense core of shortcuts.
+			// The index is a snapshot: it is undefined behavior to query it after the underlying graph has been modified.
+			template <class G, class D, class Compare, class Combine>
+			class Contraction_hierarchy {
+				using Verts = traits::Verts<G>;
+				using Edges = traits::Edges<G>;
+			public:
+				using Vert = typename Verts::value_type;
+				using Edge = typename Edges::value_type;
+				using index_type = std::uint32_t;
+				static constexpr index_type null_index = std::numeric_limits<index_type>::max();
+
+				template <class Weight>
+				Contraction_hierarchy(const G& g, const Weight& weight,
+					Compare compare, Combine combine, D zero, D inf,
+					std::size_t witness_limit = 256) :
+					_g(g), _rank(Verts::map(g, null_index)),
+					_compare(std::move(compare)), _combine(std::move(combine)),
+					_zero(std::move(zero)), _inf(std::move(inf)) {
+					_build(weight, witness_limit);
+				}
+
+				// Rank of a vertex in the contraction order; more important vertices have higher ranks.
+				index_type rank(const Vert& v) const {
+					return _rank(v);
+				}
+				// Number of shortcut arcs added during preprocessing.
+				std::size_t shortcut_count() const {
+					return _shortcuts;
+				}
+				// Length of the shortest path from `s` to `t`, or infinity if there is none.
+				D distance(const Vert& s, const Vert& t) const {
+					return _query(_index_of(s), _index_of(t)).first;
+				}
+				// Shortest path from `s` to `t` with all shortcuts unpacked, or a null path if there is none.
+				Path<G> shortest_path(const Vert& s, const Vert& t) const {
+					auto rs = _index_of(s), rt = _index_of(t);
+					auto [d, meet] = _query(rs, rt);
+					if (meet == null_index)
+						return Path<G>(_g);
+					auto& ws = _workspace();
+					std::vector<Edge> edges;
+					std::vector<index_type> arcs;
+					for (auto v = meet; v != rs; v = ws.pred[0][v])
+						arcs.push_back(ws.arc[0][v]);
+					for (auto it = arcs.rbegin(); it != arcs.rend(); ++it)
+						_unpack(false, *it, edges);
+					for (auto v = meet; v != rt; v = ws.pred[1][v])
+						_unpack(true, ws.arc[1][v], edges);
+					return Path<G>(_g, s, std::move(edges));
+				}
+
+			private:
+				struct _arc {
+					// Adjacent vertex, by index while building and by rank once built
+					index_type other;
+					D weight;
+					// Halves of a shortcut in `_down` and `_up`, or `null_index` for original edges
+					index_type first, second;
+					Edge edge;
+				};
+				using _arcs_type = std::vector<_arc>;
+
+				struct _shortcut {
+					// Positions of the halves in the in- and out-arcs of the contracted vertex
+					index_type in, out;
+					D weight;
+				};
+
+				using _heap_type = std::vector<std::pair<D, index_type>>;
+
+				struct _witness_workspace {
+					std::vector<D> distance;
+					std::vector<char> target;
+					std::vector<index_type> touched;
+					_heap_type heap;
+				};
+
+				struct _query_workspace {
+					std::vector<D> distance[2];
+					std::vector<index_type> pred[2], arc[2];
+					std::vector<unsigned> stamp[2];
+					_heap_type heap[2];
+					unsigned current = 0;
+				};
+
+				auto _heap_compare() const {
+					// arguments reversed because the standard heap algorithms build max heaps
+					return [this](const auto& l, const auto& r) { return _compare(r.first, l.first); };
+				}
+
+				index_type _index_of(const Vert& v) const {
+					auto r = _rank(v);
+					check_precondition(r != null_index, "vertex must be in the hierarchy");
+					return r;
+				}
+
+				static void _insert_arc(_arcs_type& out, _arcs_type& in,
+					index_type u, index_type x, const _arc& a, const Compare& compare) {
+					// Parallel arcs are merged by keeping the shorter
+					auto it = std::find_if(out.begin(), out.end(), [x](const _arc& b) { return b.other == x; });
+					if (it == out.end()) {
+						out.push_back(a);
+						out.back().other = x;
+						in.push_back(a);
+						in.back().other = u;
+						return;
+					}
+					if (!compare(a.weight, it->weight))
+						return;
+					*it = a;
+					it->other = x;
+					auto jt = std::find_if(in.begin(), in.end(), [u](const _arc& b) { return b.other == u; });
+					*jt = a;
+					jt->other = u;
+				}
+
+				static void _erase_arc(_arcs_type& arcs, index_type v) {
+					auto it = std::find_if(arcs.begin(), arcs.end(), [v](const _arc& b) { return b.other == v; });
+					*it = std::move(arcs.back());
+					arcs.pop_back();
+				}
+
+				// Finds the shortcuts needed to contract `v`, ignoring all vertices flagged in `excluded`, and passes each to `f`.
+				template <class F>
+				void _find_shortcuts(index_type v,
+					const std::vector<_arcs_type>& out, const std::vector<_arcs_type>& in,
+					const std::vector<char>& excluded, std::size_t witness_limit,
+					_witness_workspace& ws, F&& f) const {
+					const auto& v_in = in[v];
+					const auto& v_out = out[v];
+					auto heap_compare = _heap_compare();
+					for (index_type i = 0; i < v_in.size(); ++i) {
+						auto u = v_in[i].other;
+						const auto& a = v_in[i].weight;
+
+						// Bound the witness search by the longest path through `v`, and stop it early once every target is settled
+						std::size_t targets = 0;
+						D bound = _zero;
+						for (const auto& b : v_out) {
+							if (b.other == u)
+								continue;
+							auto c = _combine(a, b.weight);
+							if (targets == 0 || _compare(bound, c))
+								bound = c;
+							targets += !ws.target[b.other];
+							ws.target[b.other] = true;
+						}
+						if (targets == 0)
+							continue;
+
+						// Bounded Dijkstra from `u` which avoids `v`
+						ws.distance[u] = _zero;
+						ws.touched.push_back(u);
+						ws.heap.emplace_back(_zero, u);
+						std::size_t settled = 0;
+						while (!ws.heap.empty() && settled < witness_limit) {
+							std::pop_heap(ws.heap.begin(), ws.heap.end(), heap_compare);
+							auto [d, w] = ws.heap.back();
+							ws.heap.pop_back();
+							if (_compare(ws.distance[w], d))
+								continue; // stale entry
+							if (_compare(bound, d))
+								break;
+							++settled;
+							if (ws.target[w] && --targets == 0)
+								break;
+							for (const auto& b : out[w]) {
+								auto x = b.other;
+								if (x == v || excluded[x])
+									continue;
+								auto c = _combine(d, b.weight);
+								if (_compare(c, ws.distance[x])) {
+									if (!_compare(ws.distance[x], _inf))
+										ws.touched.push_back(x);
+									ws.distance[x] = c;
+									ws.heap.emplace_back(c, x);
+									std::push_heap(ws.heap.begin(), ws.heap.end(), heap_compare);
+								}
+							}
+						}
+
+						for (index_type j = 0; j < v_out.size(); ++j) {
+							const auto& b = v_out[j];
+							if (b.other == u)
+								continue;
+							auto c = _combine(a, b.weight);
+							if (_compare(c, ws.distance[b.other]))
+								f(i, j, c);
+						}
+
+						for (const auto& b : v_out)
+							ws.target[b.other] = false;
+						for (auto w : ws.touched)
+							ws.distance[w] = _inf;
+						ws.touched.clear();
+						ws.heap.clear();
+					}
+				}
+
+				template <class Weight>
+				void _build(const Weight& weight, std::size_t witness_limit) {
+					const G& g = _g;
+					auto n = static_cast<std::size_t>(Verts::size(g));
+					check_precondition(n < null_index, "too many vertices for a contraction hierarchy");
+
+					// Assign dense indices to vertices
+					std::vector<Vert> verts;
+					verts.reserve(n);
+					auto index = Verts::ephemeral_map(g, null_index);
+					for (auto v : Verts::range(g)) {
+						index[v] = static_cast<index_type>(verts.size());
+						verts.push_back(v);
+					}
+
+					// Working graph of vertices which remain to be contracted
+					std::vector<_arcs_type> out(n), in(n);
+					for (auto e : Edges::range(g)) {
+						auto u = index(Edges::tail(g, e)), x = index(Edges::head(g, e));
+						D w = weight(e);
+						check_precondition(!_compare(w, _zero), "edges must have non-negative weights");
+						// self-edges never lie on shortest paths
+						if (u == x)
+							continue;
+						_insert_arc(out[u], in[x], u, x, _arc{x, w, null_index, null_index, e}, _compare);
+					}
+
+					std::vector<index_type> remaining(n);
+					std::iota(remaining.begin(), remaining.end(), index_type{});
+					std::vector<std::int64_t> priority(n);
+					std::vector<char> dirty(n, true), selected(n, false);
+					std::vector<index_type> deleted(n, 0), rank(n, null_index);
+					std::vector<_witness_workspace> workspaces(omp_get_max_threads());
+					for (auto& ws : workspaces) {
+						ws.distance.assign(n, _inf);
+						ws.target.assign(n, false);
+					}
+
+					auto simulation_limit = std::max<std::size_t>(witness_limit / 8, 1);
+
+					_up_offsets.assign(1, 0);
+					_down_offsets.assign(1, 0);
+					index_type next_rank = 0;
+					while (!remaining.empty()) {
+						auto m = static_cast<std::ptrdiff_t>(remaining.size());
+
+						// Order by edge difference, penalizing vertices with many contracted neighbors to keep the hierarchy shallow
+						// Priorities are only estimates, so their witness searches settle far fewer vertices
+						#pragma omp parallel for schedule(dynamic, 64)
+						for (std::ptrdiff_t k = 0; k < m; ++k) {
+							auto v = remaining[k];
+							if (!dirty[v])
+								continue;
+							std::int64_t shortcuts = 0;
+							_find_shortcuts(v, out, in, selected, simulation_limit,
+								workspaces[omp_get_thread_num()],
+								[&](index_type, index_type, const D&) { ++shortcuts; });
+							priority[v] = shortcuts
+								- static_cast<std::int64_t>(in[v].size() + out[v].size())
+								+ deleted[v];
+							dirty[v] = false;
+						}
+
+						// Select an independent set of locally minimal vertices
+						auto before = [&](index_type v, index_type w) {
+							return std::pair(priority[v], v) < std::pair(priority[w], w);
+						};
+						#pragma omp parallel for schedule(static)
+						for (std::ptrdiff_t k = 0; k < m; ++k) {
+							auto v = remaining[k];
+							bool minimal = true;
+							for (const auto* arcs : { &out[v], &in[v] })
+								for (const auto& a : *arcs)
+									minimal = minimal && before(v, a.other);
+							selected[v] = minimal;
+						}
+						std::vector<index_type> batch;
+						auto kept = std::stable_partition(remaining.begin(), remaining.end(),
+							[&](index_type v) { return !selected[v]; });
+						batch.assign(kept, remaining.end());
+						remaining.erase(kept, remaining.end());
+
+						// Witness searches avoid the whole batch so that each contraction is independent of the others
+						auto b = static_cast<std::ptrdiff_t>(batch.size());
+						std::vector<std::vector<_shortcut>> shortcuts(batch.size());
+						#pragma omp parallel for schedule(dynamic, 16)
+						for (std::ptrdiff_t k = 0; k < b; ++k) {
+							_find_shortcuts(batch[k], out, in, selected, witness_limit,
+								workspaces[omp_get_thread_num()],
+								[&](index_type i, index_type j, const D& c) {
+									shortcuts[k].push_back(_shortcut{i, j, c});
+								});
+						}
+
+						// Move the arcs of each contracted vertex into the overlay and connect its neighbors
+						for (std::ptrdiff_t k = 0; k < b; ++k) {
+							auto v = batch[k];
+							rank[v] = next_rank++;
+							auto up_begin = static_cast<index_type>(_up.size());
+							auto down_begin = static_cast<index_type>(_down.size());
+							_up.insert(_up.end(), out[v].begin(), out[v].end());
+							_down.insert(_down.end(), in[v].begin(), in[v].end());
+							_up_offsets.push_back(static_cast<index_type>(_up.size()));
+							_down_offsets.push_back(static_cast<index_type>(_down.size()));
+							for (const auto& a : out[v]) {
+								_erase_arc(in[a.other], v);
+								dirty[a.other] = true;
+								++deleted[a.other];
+							}
+							for (const auto& a : in[v]) {
+								_erase_arc(out[a.other], v);
+								dirty[a.other] = true;
+								++deleted[a.other];
+							}
+							for (const auto& s : shortcuts[k]) {
+								auto u = in[v][s.in].other, x = out[v][s.out].other;
+								_insert_arc(out[u], in[x], u, x,
+									_arc{x, s.weight, down_begin + s.in, up_begin + s.out, Edges::null(g)},
+									_compare);
+								++_shortcuts;
+							}
+							_arcs_type().swap(out[v]);
+							_arcs_type().swap(in[v]);
+							selected[v] = false;
+						}
+						check_precondition(_up.size() < null_index && _down.size() < null_index,
+							"too many arcs for a contraction hierarchy");
+					}
+
+					// Address the overlay by rank so each search walks memory in a single direction
+					for (auto* arcs : { &_up, &_down })
+						for (auto& a : *arcs)
+							a.other = rank[a.other];
+					for (std::size_t i = 0; i < n; ++i)
+						_rank.assign(verts[i], rank[i]);
+				}
+
+				static _query_workspace& _workspace() {
+					thread_local _query_workspace ws;
+					return ws;
+				}
+
+				// Runs bidirectional upward searches, returning the distance and the rank of the highest vertex on a shortest path.
+				std::pair<D, index_type> _query(index_type s, index_type t) const {
+					auto& ws = _workspace();
+					auto n = _up_offsets.size() - 1;
+					if (++ws.current == 0) {
+						// stamps wrapped around, so reset them all
+						for (auto& stamp : ws.stamp)
+							std::fill(stamp.begin(), stamp.end(), 0u);
+						ws.current = 1;
+					}
+					for (int side = 0; side < 2; ++side) {
+						if (ws.distance[side].size() < n) {
+							ws.distance[side].resize(n);
+							ws.pred[side].resize(n);
+							ws.arc[side].resize(n);
+							ws.stamp[side].resize(n, 0u);
+						}
+						ws.heap[side].clear();
+					}
+					auto get = [&](int side, index_type v) -> const D& {
+						return ws.stamp[side][v] == ws.current ? ws.distance[side][v] : _inf;
+					};
+					auto heap_compare = _heap_compare();
+					auto set = [&](int side, index_type v, const D& d, index_type pred, index_type arc) {
+						ws.stamp[side][v] = ws.current;
+						ws.distance[side][v] = d;
+						ws.pred[side][v] = pred;
+						ws.arc[side][v] = arc;
+						ws.heap[side].emplace_back(d, v);
+						std::push_heap(ws.heap[side].begin(), ws.heap[side].end(), heap_compare);
+					};
+					set(0, s, _zero, null_index, null_index);
+					set(1, t, _zero, null_index, null_index);
+
+					D best = _inf;
+					index_type meet = null_index;
+					if (s == t)
+						return std::pair(_zero, s);
+					bool active[2] = { true, true };
+					for (int side = 0; active[0] || active[1]; side = active[1 - side] ? 1 - side : side) {
+						auto& heap = ws.heap[side];
+						// Each search may stop once it can no longer improve on the best rendezvous
+						if (heap.empty() || !_compare(heap.front().first, best)) {
+							active[side] = false;
+							continue;
+						}
+						std::pop_heap(heap.begin(), heap.end(), heap_compare);
+						auto [d, v] = heap.back();
+						heap.pop_back();
+						if (_compare(get(side, v), d))
+							continue; // stale entry
+						if (const auto& other = get(1 - side, v); _compare(other, _inf)) {
+							auto total = _combine(d, other);
+							if (_compare(total, best)) {
+								best = total;
+								meet = v;
+							}
+						}
+						const auto& offsets = side ? _down_offsets : _up_offsets;
+						const auto& arcs = side ? _down : _up;
+						for (auto i = offsets[v]; i < offsets[v + 1]; ++i) {
+							const auto& a = arcs[i];
+							auto c = _combine(d, a.weight);
+							if (_compare(c, get(side, a.other)))
+								set(side, a.other, c, v, i);
+						}
+					}
+					return std::pair(best, meet);
+				}
+
+				// Appends the original edges represented by an arc, expanding shortcuts without recursion.
+				void _unpack(bool down, index_type i, std::vector<Edge>& edges) const {
+					std::vector<std::pair<bool, index_type>> stack{ { down, i } };
+					while (!stack.empty()) {
+						auto [d, j] = stack.back();
+						stack.pop_back();
+						const auto& a = d ? _down[j] : _up[j];
+						if (a.first == null_index) {
+							edges.push_back(a.edge);
+						} else {
+							stack.emplace_back(false, a.second);
+							stack.emplace_back(true, a.first);
+						}
+					}
+				}
+
+				std::reference_wrapper<const G> _g;
+				typename Verts::template map_type<index_type> _rank;
+				Compare _compare;
+				Combine _combine;
+				D _zero, _inf;
+				// Upward arcs out of each rank, and downward arcs into each rank stored with their tails
+				std::vector<index_type> _up_offsets, _down_offsets;
+				_arcs_type _up, _down;
+				std::size_t _shortcuts = 0;
+			};
+		}
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "traits.hpp"
+#include "exceptions.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Numbers the vertices of a graph consecutively so that algorithms can keep their state in flat arrays.
+			// The numbering is a snapshot: it is undefined behavior to use it after the underlying graph has been modified.
+			template <class G>
+			class Dense_index {
+				using Verts = traits::Verts<G>;
+			public:
+				using Vert = typename Verts::value_type;
+				using index_type = std::uint32_t;
+				static constexpr index_type null_index = std::numeric_limits<index_type>::max();
+
+				explicit Dense_index(const G& g) :
+					_index(Verts::map(g, null_index)) {
+					_verts.reserve(static_cast<std::size_t>(Verts::size(g)));
+					check_precondition(_verts.capacity() < null_index, "too many vertices to index");
+					for (auto v : Verts::range(g)) {
+						_index.assign(v, static_cast<index_type>(_verts.size()));
+						_verts.push_back(v);
+					}
+				}
+
+				std::size_t size() const {
+					return _verts.size();
+				}
+				// Index of a vertex
+				index_type operator()(const Vert& v) const {
+					return _index(v);
+				}
+				// Vertex at an index
+				const Vert& operator[](index_type i) const {
+					return _verts[i];
+				}
+
+			private:
+				std::vector<Vert> _verts;
+				typename Verts::template map_type<index_type> _index;
+			};
+
+			// Snapshot of the edges adjacent to each vertex in compressed sparse row form.
+			template <class Adjacency, class G>
+			class Csr {
+				using Adjacent_edges = traits::Adjacent_edges<Adjacency, G>;
+			public:
+				using Edge = typename traits::Edges<G>::value_type;
+				using index_type = typename Dense_index<G>::index_type;
+
+				Csr(const G& g, const Dense_index<G>& index) {
+					auto n = index.size();
+					_offsets.reserve(n + 1);
+					_offsets.push_back(0);
+					for (index_type i = 0; i < n; ++i) {
+						for (auto e : Adjacent_edges::range(g, index[i])) {
+							_cokeys.push_back(index(traits::adjacency_cokey<Adjacency, G>(g, e)));
+							_edges.push_back(e);
+						}
+						_offsets.push_back(_edges.size());
+					}
+				}
+
+				std::size_t size() const {
+					return _offsets.size() - 1;
+				}
+				// Range of positions of the edges adjacent to the vertex at an index
+				std::size_t begin(index_type i) const {
+					return _offsets[i];
+				}
+				std::size_t end(index_type i) const {
+					return _offsets[i + 1];
+				}
+				// Index of the opposite endpoint of the edge at a position
+				index_type cokey(std::size_t k) const {
+					return _cokeys[k];
+				}
+				const Edge& edge(std::size_t k) const {
+					return _edges[k];
+				}
+				const std::vector<Edge>& edges() const {
+					return _edges;
+				}
+
+			private:
+				std::vector<std::size_t> _offsets;
+				std::vector<index_type> _cokeys;
+				std::vector<Edge> _edges;
+			};
+		}
+	}
+}
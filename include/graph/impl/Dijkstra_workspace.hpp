@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "Csr.hpp"
+#include "exceptions.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Weights of the edges of a snapshot by position, so that searches need not consult `weight` again.
+			// They are read serially, so `weight` need not be thread-safe and may throw.
+			template <class Adjacency, class G, class Weight, class Compare, class Combine, class D>
+			std::vector<D> nonnegative_weights(const Csr<Adjacency, G>& csr, const Weight& weight,
+				const Compare& compare, const Combine& combine, D zero) {
+				std::vector<D> w;
+				w.reserve(csr.edges().size());
+				for (const auto& e : csr.edges()) {
+					w.push_back(weight(e));
+					if (compare(combine(zero, w.back()), zero))
+						throw precondition_unmet("edges must have non-negative weights");
+				}
+				return w;
+			}
+
+			// Labels and queue for Dijkstra searches repeated over a dense snapshot of a graph.
+			// Labels are versioned, so starting a search costs nothing however large the graph, and nothing is allocated once the queue has grown.
+			template <class Index, class D>
+			class Dijkstra_workspace {
+			public:
+				explicit Dijkstra_workspace(std::size_t n) :
+					_distance(n), _parent(n), _version(n, 0) {
+				}
+
+				// Forgets every label and queued vertex, then labels and queues `root` at distance `zero`
+				void start(Index root, D zero) {
+					if (++_current == 0) {
+						// The counter wrapped, so every stale label must be forgotten explicitly
+						std::fill(_version.begin(), _version.end(), 0);
+						_current = 1;
+					}
+					_heap.clear();
+					_heap.emplace_back(zero, root);
+					_version[root] = _current;
+					_distance[root] = zero;
+				}
+
+				bool labelled(Index v) const {
+					return _version[v] == _current;
+				}
+				D distance(Index v, D inf) const {
+					return labelled(v) ? _distance[v] : inf;
+				}
+				// Vertex from which a labelled vertex other than the root was reached, and the position of the edge between them
+				const std::pair<Index, std::size_t>& parent(Index v) const {
+					return _parent[v];
+				}
+
+				bool empty() const {
+					return _heap.empty();
+				}
+				std::size_t size() const {
+					return _heap.size();
+				}
+				// Distance of the nearest queued vertex
+				const D& top() const {
+					return _heap.front().first;
+				}
+				// Removes the nearest queued vertex, returning it with its distance when queued, which is stale if it has since been lowered
+				template <class Compare>
+				std::pair<D, Index> pop(const Compare& compare) {
+					std::pop_heap(_heap.begin(), _heap.end(), _heap_compare(compare));
+					auto top = _heap.back();
+					_heap.pop_back();
+					return top;
+				}
+				// Labels `v` at distance `d`, reached by the edge at position `k` from `u`, and queues it
+				template <class Compare>
+				void relax(Index v, D d, Index u, std::size_t k, const Compare& compare) {
+					_version[v] = _current;
+					_distance[v] = d;
+					_parent[v] = std::pair(u, k);
+					_heap.emplace_back(d, v);
+					std::push_heap(_heap.begin(), _heap.end(), _heap_compare(compare));
+				}
+
+			private:
+				template <class Compare>
+				static auto _heap_compare(const Compare& compare) {
+					return [&compare](const std::pair<D, Index>& l, const std::pair<D, Index>& r) {
+						// arguments reversed because the standard heap algorithms build max heaps
+						return compare(r.first, l.first);
+					};
+				}
+
+				std::vector<D> _distance;
+				std::vector<std::pair<Index, std::size_t>> _parent;
+				std::vector<std::uint32_t> _version;
+				std::uint32_t _current = 0;
+				std::vector<std::pair<D, Index>> _heap;
+			};
+		}
+	}
+}
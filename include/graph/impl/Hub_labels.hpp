@@ -0,0 +1,254 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <string>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+#include "traits.hpp"
+#include "exceptions.hpp"
+#include "Csr.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Distance oracle which stores, for each vertex, distances to and from a small set of hub vertices such that every shortest path passes through a hub common to the labels of its endpoints.  A query is then a merge of two sorted labels.
+			// Labels are computed by pruned landmark labeling, processing vertices in order of decreasing importance.  Orders which reflect a hierarchy, such as contraction hierarchy ranks, give much smaller labels than the default order of decreasing degree.
+			// The index is a snapshot: it is undefined behavior to query it after the underlying graph has been modified.
+			template <class G, class D, class Compare, class Combine>
+			class Hub_labels {
+				using Verts = traits::Verts<G>;
+			public:
+				using Vert = typename Verts::value_type;
+				using index_type = typename Dense_index<G>::index_type;
+
+				// Pass `nullptr` for `importance` to order vertices by degree.
+				template <class Weight, class Importance>
+				Hub_labels(const G& g, const Weight& weight, const Importance& importance,
+					Compare compare, Combine combine, D zero, D inf) :
+					_index(g),
+					_compare(std::move(compare)), _combine(std::move(combine)),
+					_zero(std::move(zero)), _inf(std::move(inf)) {
+					_build(g, weight, importance);
+				}
+				// Reads labels previously written by `write` for the same graph.
+				Hub_labels(const G& g, std::istream& is,
+					Compare compare, Combine combine, D zero, D inf) :
+					_index(g),
+					_compare(std::move(compare)), _combine(std::move(combine)),
+					_zero(std::move(zero)), _inf(std::move(inf)) {
+					_read(is);
+				}
+
+				// Length of the shortest path from `s` to `t`, or infinity if there is none.
+				D distance(const Vert& s, const Vert& t) const {
+					auto is = _index(s), it = _index(t);
+					if (is == it)
+						return _zero;
+					// Both labels end in a sentinel hub, so only one bound needs checking
+					auto i = _out.offsets[is], j = _in.offsets[it];
+					D best = _inf;
+					for (;;) {
+						auto hi = _out.hubs[i], hj = _in.hubs[j];
+						if (hi == hj) {
+							if (hi == _sentinel)
+								break;
+							auto c = _combine(_out.distances[i], _in.distances[j]);
+							if (_compare(c, best))
+								best = c;
+						}
+						i += hi <= hj;
+						j += hj <= hi;
+					}
+					return best;
+				}
+
+				// Total number of hubs across all labels
+				std::size_t hub_count() const {
+					return _out.hubs.size() + _in.hubs.size() - 2 * _index.size();
+				}
+
+				// Writes the labels in a binary format, using the native byte order.
+				void write(std::ostream& os) const {
+					static_assert(std::is_trivially_copyable_v<D>, "distances must be trivially copyable to be written");
+					std::uint64_t header[] = { _magic, _index.size(), sizeof(D) };
+					_write(os, header, 3);
+					for (const auto* label : { &_out, &_in }) {
+						std::uint64_t size = label->hubs.size();
+						_write(os, &size, 1);
+						_write(os, label->offsets.data(), label->offsets.size());
+						_write(os, label->hubs.data(), label->hubs.size());
+						_write(os, label->distances.data(), label->distances.size());
+					}
+				}
+
+			private:
+				static constexpr index_type _sentinel = std::numeric_limits<index_type>::max();
+				static constexpr std::uint64_t _magic = 0x3162616c20627568; // "hub lab1"
+
+				// Hub ranks and distances of every label, stored separately and concatenated
+				struct _labels {
+					std::vector<std::uint64_t> offsets;
+					std::vector<index_type> hubs;
+					std::vector<D> distances;
+				};
+
+				template <class T>
+				static void _write(std::ostream& os, const T* data, std::size_t size) {
+					os.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size * sizeof(T)));
+				}
+				template <class T>
+				static void _read(std::istream& is, T* data, std::size_t size) {
+					if (!is.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(size * sizeof(T))))
+						throw format_error({"hub labels"}, "end-of-file");
+				}
+
+				void _read(std::istream& is) {
+					static_assert(std::is_trivially_copyable_v<D>, "distances must be trivially copyable to be read");
+					std::uint64_t header[3];
+					_read(is, header, 3);
+					if (header[0] != _magic || header[2] != sizeof(D))
+						throw format_error({"hub labels"}, "unrecognized header");
+					if (header[1] != _index.size())
+						throw format_error({"hub labels for this graph"}, "labels for " + std::to_string(header[1]) + " vertices");
+					for (auto* label : { &_out, &_in }) {
+						std::uint64_t size;
+						_read(is, &size, 1);
+						label->offsets.resize(_index.size() + 1);
+						_read(is, label->offsets.data(), label->offsets.size());
+						// Reject offsets that would index out of bounds before allocating
+						for (std::size_t i = 0; i < _index.size(); ++i)
+							if (label->offsets[i] >= label->offsets[i + 1] || label->offsets[i + 1] > size)
+								throw format_error({"hub labels"}, "invalid offsets");
+						label->hubs.resize(size);
+						label->distances.resize(size);
+						_read(is, label->hubs.data(), size);
+						_read(is, label->distances.data(), size);
+						for (std::size_t i = 0; i < _index.size(); ++i)
+							if (label->hubs[label->offsets[i + 1] - 1] != _sentinel)
+								throw format_error({"hub labels"}, "unterminated label");
+					}
+				}
+
+				template <class Weight, class Importance>
+				void _build(const G& g, const Weight& weight, const Importance& importance) {
+					auto n = _index.size();
+					Csr<traits::Out, G> out(g, _index);
+					Csr<traits::In, G> in(g, _index);
+					std::vector<D> out_weight, in_weight;
+					for (auto [csr, w] : { std::pair(&out.edges(), &out_weight), std::pair(&in.edges(), &in_weight) }) {
+						w->reserve(csr->size());
+						for (const auto& e : *csr) {
+							w->push_back(weight(e));
+							check_precondition(!_compare(w->back(), _zero), "edges must have non-negative weights");
+						}
+					}
+
+					// Vertices which lie on many shortest paths come first so that they prune the most
+					std::vector<index_type> order(n);
+					std::iota(order.begin(), order.end(), index_type{});
+					if constexpr (std::is_null_pointer_v<Importance>) {
+						auto degree = [&](index_type v) {
+							return (out.end(v) - out.begin(v)) + (in.end(v) - in.begin(v));
+						};
+						std::stable_sort(order.begin(), order.end(),
+							[&](index_type v, index_type u) { return degree(u) < degree(v); });
+					} else {
+						std::stable_sort(order.begin(), order.end(),
+							[&](index_type v, index_type u) { return importance(_index[u]) < importance(_index[v]); });
+					}
+
+					// Labels grow in rank order, so they stay sorted by hub
+					std::vector<std::vector<std::pair<index_type, D>>> out_labels(n), in_labels(n);
+					std::vector<D> hub_distance(n, _inf), distance(n, _inf);
+					std::vector<index_type> touched;
+					std::vector<std::pair<D, index_type>> heap;
+					auto heap_compare = [this](const auto& l, const auto& r) {
+						// arguments reversed because the standard heap algorithms build max heaps
+						return _compare(r.first, l.first);
+					};
+					auto search = [&](bool forward, index_type rank, index_type h,
+						const auto& csr, const std::vector<D>& w,
+						const std::vector<std::vector<std::pair<index_type, D>>>& near,
+						std::vector<std::vector<std::pair<index_type, D>>>& far) {
+						for (const auto& [hub, d] : near[h])
+							hub_distance[hub] = d;
+						distance[h] = _zero;
+						touched.push_back(h);
+						heap.emplace_back(_zero, h);
+						while (!heap.empty()) {
+							std::pop_heap(heap.begin(), heap.end(), heap_compare);
+							auto [d, v] = heap.back();
+							heap.pop_back();
+							if (_compare(distance[v], d))
+								continue; // stale entry
+							// Prune vertices whose distance is already covered by more important hubs
+							bool covered = false;
+							for (const auto& [hub, dv] : far[v]) {
+								if (!_compare(hub_distance[hub], _inf))
+									continue;
+								auto c = forward ? _combine(hub_distance[hub], dv) : _combine(dv, hub_distance[hub]);
+								if (!_compare(d, c)) {
+									covered = true;
+									break;
+								}
+							}
+							if (covered)
+								continue;
+							far[v].emplace_back(rank, d);
+							for (auto j = csr.begin(v); j < csr.end(v); ++j) {
+								auto u = csr.cokey(j);
+								auto c = forward ? _combine(d, w[j]) : _combine(w[j], d);
+								if (_compare(c, distance[u])) {
+									if (!_compare(distance[u], _inf))
+										touched.push_back(u);
+									distance[u] = c;
+									heap.emplace_back(c, u);
+									std::push_heap(heap.begin(), heap.end(), heap_compare);
+								}
+							}
+						}
+						for (auto v : touched)
+							distance[v] = _inf;
+						touched.clear();
+						for (const auto& [hub, d] : near[h])
+							hub_distance[hub] = _inf;
+					};
+					for (index_type rank = 0; rank < n; ++rank) {
+						auto h = order[rank];
+						// Forward from `h` labels distances from the hub, backward labels distances to it
+						search(true, rank, h, out, out_weight, out_labels, in_labels);
+						search(false, rank, h, in, in_weight, in_labels, out_labels);
+					}
+
+					for (auto [labels, flat] : { std::pair(&out_labels, &_out), std::pair(&in_labels, &_in) }) {
+						flat->offsets.assign(1, 0);
+						for (auto& label : *labels) {
+							for (const auto& [hub, d] : label) {
+								flat->hubs.push_back(hub);
+								flat->distances.push_back(d);
+							}
+							flat->hubs.push_back(_sentinel);
+							flat->distances.push_back(_inf);
+							flat->offsets.push_back(flat->hubs.size());
+							std::vector<std::pair<index_type, D>>().swap(label);
+						}
+					}
+				}
+
+				Dense_index<G> _index;
+				Compare _compare;
+				Combine _combine;
+				D _zero, _inf;
+				_labels _out, _in;
+			};
+		}
+	}
+}
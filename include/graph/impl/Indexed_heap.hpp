@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <algorithm>
+
+#include "exceptions.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Priority queue holding each key at most once, which can lower the priority of a key in place.
+			// `Positions` maps each key to its position in the heap, or `npos` if it is absent, and should start out mapping every key to `npos`; an ephemeral vertex map is contiguous on graphs with integral vertices.  A wider heap is shallower, so sifting down is cheaper to cache.
+			template <class Key, class Priority, class Positions, class Compare = std::less<>, std::size_t Arity = 4>
+			class Indexed_heap {
+				static_assert(Arity >= 2, "heap must have an arity of at least two");
+			public:
+				static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+				explicit Indexed_heap(Positions positions, const Compare& compare = {}) :
+					_positions(std::move(positions)), _compare(compare) {
+				}
+
+				bool empty() const {
+					return _heap.empty();
+				}
+				std::size_t size() const {
+					return _heap.size();
+				}
+				bool contains(const Key& k) const {
+					return _positions(k) != npos;
+				}
+				// Key with the least priority
+				const Key& top() const {
+					return _heap.front().first;
+				}
+				const Priority& priority(const Key& k) const {
+					return _heap[_positions(k)].second;
+				}
+
+				// Inserts a key which is not already present
+				void push(Key k, Priority p) {
+					check_precondition(!contains(k), "key must not already be in the heap");
+					_heap.emplace_back(std::move(k), std::move(p));
+					_sift_up(_heap.size() - 1);
+				}
+				// Lowers the priority of a key which is already present
+				void decrease(const Key& k, Priority p) {
+					auto i = _positions(k);
+					check_precondition(!_compare(_heap[i].second, p), "priority must not increase");
+					_heap[i].second = std::move(p);
+					_sift_up(i);
+				}
+				// Inserts a key or lowers its priority, returning whether it was inserted or lowered
+				bool push_or_decrease(const Key& k, Priority p) {
+					auto i = _positions(k);
+					if (i == npos) {
+						push(k, std::move(p));
+						return true;
+					}
+					if (!_compare(p, _heap[i].second))
+						return false;
+					_heap[i].second = std::move(p);
+					_sift_up(i);
+					return true;
+				}
+				// Removes and returns the key with the least priority and its priority
+				std::pair<Key, Priority> pop() {
+					auto top = std::move(_heap.front());
+					_positions.assign(top.first, npos);
+					if (_heap.size() > 1) {
+						_heap.front() = std::move(_heap.back());
+						_heap.pop_back();
+						_sift_down(0);
+					} else {
+						_heap.pop_back();
+					}
+					return top;
+				}
+
+			private:
+				// Moves the element at `i` towards the root, shifting parents down into the hole rather than swapping
+				void _sift_up(std::size_t i) {
+					auto x = std::move(_heap[i]);
+					while (i > 0) {
+						auto parent = (i - 1) / Arity;
+						if (!_compare(x.second, _heap[parent].second))
+							break;
+						_place(i, std::move(_heap[parent]));
+						i = parent;
+					}
+					_place(i, std::move(x));
+				}
+				void _sift_down(std::size_t i) {
+					auto x = std::move(_heap[i]);
+					auto size = _heap.size();
+					for (;;) {
+						auto first = i * Arity + 1;
+						if (first >= size)
+							break;
+						auto last = std::min(first + Arity, size), least = first;
+						for (auto child = first + 1; child < last; ++child)
+							if (_compare(_heap[child].second, _heap[least].second))
+								least = child;
+						if (!_compare(_heap[least].second, x.second))
+							break;
+						_place(i, std::move(_heap[least]));
+						i = least;
+					}
+					_place(i, std::move(x));
+				}
+				void _place(std::size_t i, std::pair<Key, Priority>&& x) {
+					_positions.assign(x.first, i);
+					_heap[i] = std::move(x);
+				}
+
+				std::vector<std::pair<Key, Priority>> _heap;
+				Positions _positions;
+				Compare _compare;
+			};
+		}
+	}
+}
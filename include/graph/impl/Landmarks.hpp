@@ -0,0 +1,337 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <exception>
+
+#include "traits.hpp"
+#include "exceptions.hpp"
+#include "omp.hpp"
+#include "Csr.hpp"
+#include "Path.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Lower bounds on distances derived from the triangle inequality and precomputed distances to and from a few landmark vertices.  Goal-directed searches use them to skip vertices which lead away from their target.
+			// Unlike most algorithms in this library, weights must be arithmetic since lower bounds are taken from differences of distances.
+			// The index is a snapshot: it is undefined behavior to query it after the underlying graph has been modified.
+			template <class G, class D>
+			class Landmarks {
+				static_assert(std::is_arithmetic_v<D>, "landmark distances must be arithmetic");
+				using Verts = traits::Verts<G>;
+				using Edges = traits::Edges<G>;
+			public:
+				using Vert = typename Verts::value_type;
+				using Edge = typename Edges::value_type;
+				using index_type = typename Dense_index<G>::index_type;
+				// Distances are stored compactly since bounds need not be exact
+				using value_type = std::conditional_t<std::is_integral_v<D>, std::uint32_t, float>;
+
+				template <class Weight, class Random>
+				Landmarks(const G& g, const Weight& weight, std::size_t k, Random& random) :
+					_g(g), _index(g),
+					_out(g, _index), _in(g, _index) {
+					_build(weight, std::min(k, _index.size()), random);
+				}
+
+				// Number of landmarks
+				std::size_t size() const {
+					return _landmarks.size();
+				}
+				const Vert& landmark(std::size_t i) const {
+					return _index[_landmarks[i]];
+				}
+
+				// Lower bound on the length of the shortest path from `u` to `v`, or infinity if there is none.
+				D lower_bound(const Vert& u, const Vert& v) const {
+					auto b = _bound(_index(u), _index(v));
+					if (b == _unbounded)
+						return _inf;
+					return static_cast<D>(b);
+				}
+				// Length of the shortest path from `s` to `t`, or infinity if there is none.
+				D distance(const Vert& s, const Vert& t) const {
+					return _query(_index(s), _index(t)).first;
+				}
+				// Shortest path from `s` to `t`, or a null path if there is none.
+				Path<G> shortest_path(const Vert& s, const Vert& t) const {
+					auto is = _index(s), it = _index(t);
+					auto [d, meet] = _query(is, it);
+					if (meet == null_index)
+						return Path<G>(_g);
+					auto& ws = _workspace();
+					std::vector<Edge> edges;
+					for (auto v = meet; v != is; v = ws.pred[0][v])
+						edges.push_back(_out.edge(ws.arc[0][v]));
+					std::reverse(edges.begin(), edges.end());
+					for (auto v = meet; v != it; v = ws.pred[1][v])
+						edges.push_back(_in.edge(ws.arc[1][v]));
+					return Path<G>(_g, s, std::move(edges));
+				}
+
+			private:
+				static constexpr index_type null_index = Dense_index<G>::null_index;
+				static constexpr value_type _unreachable = std::numeric_limits<value_type>::max();
+				static constexpr double _unbounded = std::numeric_limits<double>::infinity();
+				static constexpr D _inf = std::numeric_limits<D>::max();
+
+				using _heap_type = std::vector<std::pair<double, index_type>>;
+				static bool _heap_compare(const std::pair<double, index_type>& l, const std::pair<double, index_type>& r) {
+					// arguments reversed because the standard heap algorithms build max heaps
+					return r.first < l.first;
+				}
+
+				struct _query_workspace {
+					std::vector<D> distance[2];
+					std::vector<index_type> pred[2];
+					std::vector<std::size_t> arc[2];
+					std::vector<double> potential;
+					std::vector<unsigned> stamp[2], potential_stamp;
+					_heap_type heap[2];
+					unsigned current = 0;
+				};
+
+				static _query_workspace& _workspace() {
+					thread_local _query_workspace ws;
+					return ws;
+				}
+
+				// Dijkstra's algorithm over a snapshot, writing distances into every `k`th element of `out`
+				template <class Adjacency>
+				void _search(const Csr<Adjacency, G>& csr, const std::vector<D>& weight, index_type s,
+					std::vector<D>& distance, std::vector<value_type>& out, std::size_t k, std::size_t i) const {
+					std::vector<std::pair<D, index_type>> heap;
+					auto heap_compare = [](const auto& l, const auto& r) { return r.first < l.first; };
+					distance.assign(_index.size(), _inf);
+					distance[s] = D{};
+					heap.emplace_back(D{}, s);
+					while (!heap.empty()) {
+						std::pop_heap(heap.begin(), heap.end(), heap_compare);
+						auto [d, v] = heap.back();
+						heap.pop_back();
+						if (distance[v] < d)
+							continue; // stale entry
+						for (auto j = csr.begin(v); j < csr.end(v); ++j) {
+							auto u = csr.cokey(j);
+							auto c = d + weight[j];
+							if (c < distance[u]) {
+								distance[u] = c;
+								heap.emplace_back(c, u);
+								std::push_heap(heap.begin(), heap.end(), heap_compare);
+							}
+						}
+					}
+					for (std::size_t v = 0; v < distance.size(); ++v) {
+						auto d = distance[v];
+						if (d == _inf) {
+							out[v * k + i] = _unreachable;
+						} else {
+							check_precondition(!std::is_integral_v<D> || d < static_cast<D>(_unreachable),
+								"landmark distances must fit in 32 bits");
+							out[v * k + i] = static_cast<value_type>(d);
+						}
+					}
+				}
+
+				template <class Adjacency, class Weight>
+				static std::vector<D> _weights(const Csr<Adjacency, G>& csr, const Weight& weight) {
+					std::vector<D> w;
+					w.reserve(csr.edges().size());
+					for (const auto& e : csr.edges()) {
+						w.push_back(weight(e));
+						check_precondition(!(w.back() < D{}), "edges must have non-negative weights");
+					}
+					return w;
+				}
+
+				template <class Weight, class Random>
+				void _build(const Weight& weight, std::size_t k, Random& random) {
+					auto n = _index.size();
+					_out_weight = _weights(_out, weight);
+					_in_weight = _weights(_in, weight);
+					_k = k;
+					_from.assign(n * k, _unreachable);
+					_to.assign(n * k, _unreachable);
+					if (k == 0)
+						return;
+
+					// Choose landmarks far from each other, starting from the vertex farthest from a random one
+					std::vector<D> distance, closest(n, _inf);
+					std::vector<value_type> scratch(n);
+					std::vector<char> chosen(n, false);
+					_search(_out, _out_weight, std::uniform_int_distribution<index_type>(0, n - 1)(random),
+						closest, scratch, 1, 0);
+					for (std::size_t i = 0; i < k; ++i) {
+						index_type l = null_index;
+						for (index_type v = 0; v < n; ++v)
+							if (!chosen[v] && (l == null_index || closest[l] < closest[v]))
+								l = v;
+						chosen[l] = true;
+						_landmarks.push_back(l);
+						_search(_out, _out_weight, l, distance, _from, k, i);
+						for (index_type v = 0; v < n; ++v)
+							closest[v] = std::min(closest[v], distance[v]);
+					}
+
+					// Distances to landmarks are independent of one another.  Exceptions cannot escape a parallel region, so the first is kept to be rethrown after it.
+					auto m = static_cast<std::ptrdiff_t>(k);
+					std::exception_ptr ex;
+					#pragma omp parallel for schedule(dynamic, 1)
+					for (std::ptrdiff_t i = 0; i < m; ++i) {
+						try {
+							std::vector<D> d;
+							_search(_in, _in_weight, _landmarks[i], d, _to, k, i);
+						} catch (...) {
+							#pragma omp critical(graph_landmarks_exception)
+							if (!ex)
+								ex = std::current_exception();
+						}
+					}
+					if (ex)
+						std::rethrow_exception(ex);
+				}
+
+				// Difference of two stored distances, conservatively rounded down
+				static double _difference(value_type a, value_type b) {
+					auto d = static_cast<double>(a) - static_cast<double>(b);
+					if constexpr (std::is_floating_point_v<value_type>)
+						d -= (static_cast<double>(a) + static_cast<double>(b)) * std::numeric_limits<value_type>::epsilon();
+					return d;
+				}
+
+				double _bound(index_type u, index_type v) const {
+					double b = 0;
+					const auto *from_u = &_from[u * _k], *from_v = &_from[v * _k];
+					const auto *to_u = &_to[u * _k], *to_v = &_to[v * _k];
+					for (std::size_t i = 0; i < _k; ++i) {
+						// A landmark which reaches `u` but not `v`, or is reached by `v` but not `u`, proves there is no path
+						if (from_v[i] == _unreachable) {
+							if (from_u[i] != _unreachable)
+								return _unbounded;
+						} else if (from_u[i] != _unreachable) {
+							b = std::max(b, _difference(from_v[i], from_u[i]));
+						}
+						if (to_u[i] == _unreachable) {
+							if (to_v[i] != _unreachable)
+								return _unbounded;
+						} else if (to_v[i] != _unreachable) {
+							b = std::max(b, _difference(to_u[i], to_v[i]));
+						}
+					}
+					return b;
+				}
+
+				// Runs bidirectional A* with averaged potentials, returning the distance and a vertex on a shortest path.
+				std::pair<D, index_type> _query(index_type s, index_type t) const {
+					auto& ws = _workspace();
+					auto n = _index.size();
+					if (++ws.current == 0) {
+						// stamps wrapped around, so reset them all
+						for (auto* stamp : { &ws.stamp[0], &ws.stamp[1], &ws.potential_stamp })
+							std::fill(stamp->begin(), stamp->end(), 0u);
+						ws.current = 1;
+					}
+					if (ws.potential.size() < n) {
+						for (int side = 0; side < 2; ++side) {
+							ws.distance[side].resize(n);
+							ws.pred[side].resize(n);
+							ws.arc[side].resize(n);
+							ws.stamp[side].resize(n, 0u);
+						}
+						ws.potential.resize(n);
+						ws.potential_stamp.resize(n, 0u);
+					}
+					for (auto& heap : ws.heap)
+						heap.clear();
+
+					if (s == t)
+						return std::pair(D{}, s);
+					if (_bound(s, t) == _unbounded)
+						return std::pair(_inf, null_index);
+
+					// The forward search uses half the difference of the bounds to `t` and from `s` as its potential, and the backward search its negation, so that both agree on reduced weights
+					auto potential = [&](index_type v) {
+						if (ws.potential_stamp[v] != ws.current) {
+							ws.potential_stamp[v] = ws.current;
+							auto to_t = _bound(v, t), from_s = _bound(s, v);
+							ws.potential[v] = to_t == _unbounded || from_s == _unbounded ?
+								_unbounded : (to_t - from_s) / 2;
+						}
+						return ws.potential[v];
+					};
+					auto get = [&](int side, index_type v) {
+						return ws.stamp[side][v] == ws.current ? ws.distance[side][v] : _inf;
+					};
+					auto set = [&](int side, index_type v, D d, index_type pred, std::size_t arc) {
+						ws.stamp[side][v] = ws.current;
+						ws.distance[side][v] = d;
+						ws.pred[side][v] = pred;
+						ws.arc[side][v] = arc;
+						auto p = potential(v);
+						ws.heap[side].emplace_back(static_cast<double>(d) + (side ? -p : p), v);
+						std::push_heap(ws.heap[side].begin(), ws.heap[side].end(), _heap_compare);
+					};
+					set(0, s, D{}, null_index, 0);
+					set(1, t, D{}, null_index, 0);
+
+					D best = _inf;
+					index_type meet = null_index;
+					while (!ws.heap[0].empty() && !ws.heap[1].empty()) {
+						// Stop once no unsettled vertex can lie on a shorter path
+						if (best != _inf && ws.heap[0].front().first + ws.heap[1].front().first >= static_cast<double>(best))
+							break;
+						int side = ws.heap[1].size() < ws.heap[0].size();
+						auto& heap = ws.heap[side];
+						std::pop_heap(heap.begin(), heap.end(), _heap_compare);
+						auto [key, v] = heap.back();
+						heap.pop_back();
+						auto d = get(side, v);
+						auto p = potential(v);
+						if (key > static_cast<double>(d) + (side ? -p : p))
+							continue; // stale entry
+						auto relax = [&](const auto& adjacency, const std::vector<D>& weight) {
+							for (auto j = adjacency.begin(v); j < adjacency.end(v); ++j) {
+								auto u = adjacency.cokey(j);
+								if (potential(u) == _unbounded)
+									continue; // `u` lies on no path from `s` to `t`
+								auto c = d + weight[j];
+								if (c < get(side, u))
+									set(side, u, c, v, j);
+								if (auto other = get(1 - side, u); other != _inf) {
+									auto total = get(side, u) + other;
+									if (total < best) {
+										best = total;
+										meet = u;
+									}
+								}
+							}
+						};
+						if (side)
+							relax(_in, _in_weight);
+						else
+							relax(_out, _out_weight);
+					}
+					return std::pair(best, meet);
+				}
+
+				std::reference_wrapper<const G> _g;
+				Dense_index<G> _index;
+				Csr<traits::Out, G> _out;
+				Csr<traits::In, G> _in;
+				std::vector<D> _out_weight, _in_weight;
+				std::size_t _k = 0;
+				std::vector<index_type> _landmarks;
+				// Distances from and to each landmark, grouped by vertex so a bound reads contiguous memory
+				std::vector<value_type> _from, _to;
+			};
+		}
+	}
+}
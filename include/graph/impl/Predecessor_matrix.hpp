@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#include "traits.hpp"
+#include "exceptions.hpp"
+#include "Csr.hpp"
+#include "Path.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Shortest paths between all pairs of vertices, stored as the last edge of the path between each pair.  Paths are reconstructed on demand by following these edges back to the source.
+			// Like `Dense_index`, it is a snapshot: it is undefined behavior to use it after the underlying graph has been modified.
+			template <class G>
+			class Predecessor_matrix {
+				using Edges = traits::Edges<G>;
+			public:
+				using Vert = typename Dense_index<G>::Vert;
+				using Edge = typename Edges::value_type;
+				using index_type = typename Dense_index<G>::index_type;
+				static constexpr index_type null_index = Dense_index<G>::null_index;
+
+				explicit Predecessor_matrix(const G& g) :
+					_g(g), _index(g),
+					_data(_index.size() * _index.size(), null_index) {
+					_edges.reserve(static_cast<std::size_t>(Edges::size(g)));
+					check_precondition(_edges.capacity() < null_index, "too many edges to index");
+					for (auto e : Edges::range(g))
+						_edges.push_back(e);
+				}
+
+				std::size_t order() const {
+					return _index.size();
+				}
+				const Dense_index<G>& index() const {
+					return _index;
+				}
+				// Edges which may appear in paths, indexed by the elements of `data`
+				const std::vector<Edge>& edges() const {
+					return _edges;
+				}
+
+				// Last edge of the shortest path from `s` to `t`, or null if there is none or `s` is `t`.
+				Edge in_edge_or_null(const Vert& s, const Vert& t) const {
+					auto k = _data[std::size_t(_index(s)) * order() + _index(t)];
+					return k == null_index ? Edges::null(_g) : _edges[k];
+				}
+				// Shortest path from `s` to `t`, or a null path if there is none.
+				Path<G> path(const Vert& s, const Vert& t) const {
+					const G& g = _g;
+					const index_type* row = &_data[std::size_t(_index(s)) * order()];
+					std::vector<Edge> edges;
+					for (auto v = t; v != s;) {
+						auto k = row[_index(v)];
+						if (k == null_index)
+							return Path<G>(g);
+						edges.push_back(_edges[k]);
+						v = Edges::tail(g, _edges[k]);
+					}
+					std::reverse(edges.begin(), edges.end());
+					return Path<G>(g, s, std::move(edges));
+				}
+
+				// Underlying row-major storage of edge positions, indexed by `Dense_index`
+				index_type* data() {
+					return _data.data();
+				}
+				const index_type* data() const {
+					return _data.data();
+				}
+
+			private:
+				std::reference_wrapper<const G> _g;
+				Dense_index<G> _index;
+				std::vector<Edge> _edges;
+				std::vector<index_type> _data;
+			};
+		}
+	}
+}
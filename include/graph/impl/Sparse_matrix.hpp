@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include "traits.hpp"
+#include "omp.hpp"
+#include "Csr.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		// Semirings supply `zero()`, the identity of `add` which `multiply` annihilates, along with `add` and `multiply` themselves.  Any type with these members may be used; the ones below have vectorized kernels.
+
+		// Ordinary arithmetic, as for PageRank-like iterations
+		template <class T>
+		struct Plus_times {
+			using value_type = T;
+			T zero() const { return T{}; }
+			T add(T a, T b) const { return a + b; }
+			T multiply(T a, T b) const { return a * b; }
+		};
+		// Tropical semiring, as for shortest paths; the largest value is infinite and never overflows
+		template <class T>
+		struct Min_plus {
+			using value_type = T;
+			T zero() const { return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max(); }
+			T add(T a, T b) const { return std::min(a, b); }
+			T multiply(T a, T b) const {
+				// Branch-free so that it vectorizes
+				bool finite = a != zero() && b != zero();
+				return finite ? T(a + b) : zero();
+			}
+		};
+		// Boolean semiring, as for reachability, on bytes of zero or one since `std::vector<bool>` is packed
+		struct Or_and {
+			using value_type = unsigned char;
+			unsigned char zero() const { return 0; }
+			unsigned char add(unsigned char a, unsigned char b) const { return a | b; }
+			unsigned char multiply(unsigned char a, unsigned char b) const { return a & b; }
+		};
+
+		// Mask which selects every index
+		struct No_mask {
+			constexpr bool operator()(std::size_t) const { return true; }
+		};
+
+		// Vector storing only its entries which are not zero, in order of index
+		template <class T>
+		struct Sparse_vector {
+			using index_type = std::uint32_t;
+			std::vector<index_type> indices;
+			std::vector<T> values;
+
+			std::size_t size() const {
+				return indices.size();
+			}
+			void push_back(index_type i, T value) {
+				indices.push_back(i);
+				values.push_back(std::move(value));
+			}
+		};
+
+		namespace impl {
+			// Sparse matrix in compressed sparse row form, with a row and a column for each vertex of a graph by its `Dense_index`, holding the weight of each edge from the vertex of its row to the vertex of its column.
+			// Like `Dense_index`, it is a snapshot: it is undefined behavior to use it after the graph has been modified.  Parallel edges are kept as separate entries, which semiring addition combines.
+			template <class G, class T>
+			class Sparse_matrix {
+				using Edges = traits::Edges<G>;
+			public:
+				using Vert = typename Dense_index<G>::Vert;
+				using index_type = typename Dense_index<G>::index_type;
+				using value_type = T;
+
+				// Builds the matrix from the edge list alone by counting sort, so any graph will do
+				template <class Weight>
+				Sparse_matrix(const G& g, const Weight& weight) :
+					_index(g), _offsets(_index.size() + 1) {
+					for (auto e : Edges::range(g))
+						++_offsets[_index(Edges::tail(g, e)) + 1];
+					for (std::size_t i = 0; i < _index.size(); ++i)
+						_offsets[i + 1] += _offsets[i];
+					_columns.resize(_offsets.back());
+					_values.resize(_offsets.back());
+					auto next = _offsets;
+					for (auto e : Edges::range(g)) {
+						auto k = next[_index(Edges::tail(g, e))]++;
+						_columns[k] = _index(Edges::head(g, e));
+						_values[k] = weight(e);
+					}
+				}
+
+				std::size_t order() const {
+					return _index.size();
+				}
+				const Dense_index<G>& index() const {
+					return _index;
+				}
+				// Range of positions of the entries in a row
+				std::size_t begin(index_type i) const {
+					return _offsets[i];
+				}
+				std::size_t end(index_type i) const {
+					return _offsets[i + 1];
+				}
+				const index_type* columns() const {
+					return _columns.data();
+				}
+				const T* values() const {
+					return _values.data();
+				}
+
+				// Matrix with rows and columns exchanged, which holds the weights of the reversed edges
+				Sparse_matrix transpose() const {
+					Sparse_matrix t(*this, 0);
+					for (std::size_t k = 0; k < _columns.size(); ++k)
+						++t._offsets[_columns[k] + 1];
+					for (std::size_t i = 0; i < order(); ++i)
+						t._offsets[i + 1] += t._offsets[i];
+					auto next = t._offsets;
+					for (index_type i = 0; i < order(); ++i) {
+						for (auto k = begin(i); k < end(i); ++k) {
+							auto l = next[_columns[k]]++;
+							t._columns[l] = i;
+							t._values[l] = _values[k];
+						}
+					}
+					return t;
+				}
+
+			private:
+				// Empty matrix of the same shape and number of entries
+				Sparse_matrix(const Sparse_matrix& m, int) :
+					_index(m._index), _offsets(m._offsets.size()),
+					_columns(m._columns.size()), _values(m._values.size()) {
+				}
+
+				Dense_index<G> _index;
+				std::vector<std::size_t> _offsets;
+				std::vector<index_type> _columns;
+				std::vector<T> _values;
+			};
+
+			// Sum over `[first, last)` of the products of matrix entries with the entries of `x` in their columns.
+			// The semirings above are recognized at compile time and reduced with SIMD; others are reduced in order.
+			template <class Semiring, class T, class Index>
+			T _dot(const Semiring& semiring, const T* values, const Index* columns,
+				std::size_t first, std::size_t last, const T* x) {
+				T sum = semiring.zero();
+				if constexpr (std::is_same_v<Semiring, Plus_times<T>> && std::is_arithmetic_v<T>) {
+					#pragma omp simd reduction(+: sum)
+					for (auto k = first; k < last; ++k)
+						sum += values[k] * x[columns[k]];
+				} else if constexpr (std::is_same_v<Semiring, Min_plus<T>> && std::is_arithmetic_v<T>) {
+					#pragma omp simd reduction(min: sum)
+					for (auto k = first; k < last; ++k)
+						sum = std::min(sum, semiring.multiply(values[k], x[columns[k]]));
+				} else if constexpr (std::is_same_v<Semiring, Or_and> && std::is_same_v<T, unsigned char>) {
+					#pragma omp simd reduction(|: sum)
+					for (auto k = first; k < last; ++k)
+						sum |= values[k] & x[columns[k]];
+				} else {
+					for (auto k = first; k < last; ++k)
+						sum = semiring.add(sum, semiring.multiply(values[k], x[columns[k]]));
+				}
+				return sum;
+			}
+		}
+	}
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#include "traits.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		// Visitor which ignores every event.  Visitors derive from it and hide the hooks they handle; hooks are resolved at compile time, so those left out cost nothing.
+		struct Traversal_visitor {
+			// Called when a vertex is first reached
+			template <class Vert> void discover_vert(const Vert&) {}
+			// Called once every edge adjacent to a vertex has been examined (and, depth-first, every vertex discovered through them finished)
+			template <class Vert> void finish_vert(const Vert&) {}
+			// Called with the edge by which a vertex is discovered, just before `discover_vert`
+			template <class Edge> void tree_edge(const Edge&) {}
+			// Depth-first only: called with an edge to a discovered but unfinished vertex, which closes a cycle
+			template <class Edge> void back_edge(const Edge&) {}
+			// Depth-first only: called with an edge to a finished vertex
+			template <class Edge> void forward_or_cross_edge(const Edge&) {}
+			// Breadth-first only: called with an edge to an already discovered vertex
+			template <class Edge> void non_tree_edge(const Edge&) {}
+		};
+
+		namespace impl {
+			// Iterative depth- and breadth-first traversal along `Adjacency` edges.
+			// It keeps its stack, queue, and colours between traversals, so traversing from every vertex in turn visits each vertex once and allocates only while the workspace grows.  Nothing is recursive, so arbitrarily deep graphs cannot overflow the call stack.
+			template <class Adjacency, class G>
+			class Traversal {
+				using Verts = traits::Verts<G>;
+				using Edges = traits::Edges<G>;
+				using Adjacent_edges = traits::Adjacent_edges<Adjacency, G>;
+			public:
+				using Vert = typename Verts::value_type;
+				using Edge = typename Edges::value_type;
+
+				explicit Traversal(const G& g) :
+					_g(g), _colour(Verts::ephemeral_map(g, _white)) {
+				}
+
+				// Whether `v` has been discovered since construction or the last `reset`.
+				bool discovered(const Vert& v) const {
+					return _colour(v) != _white;
+				}
+				// Forgets every discovered vertex, in time proportional to their number.
+				void reset() {
+					for (const auto& v : _discovered)
+						_colour.assign(v, _white);
+					_discovered.clear();
+				}
+
+				// Traverses depth-first from `s` unless it has already been discovered, skipping vertices discovered by earlier traversals.
+				// The stack holds every edge examined but not yet followed, so it may grow with the number of edges rather than the depth.
+				template <class Visitor>
+				void depth_first_from(const Vert& s, Visitor&& visitor) {
+					const G& g = _g;
+					if (discovered(s))
+						return;
+					_stack.push_back(_frame{ s, Edges::null(g), false });
+					while (!_stack.empty()) {
+						auto [v, e, finish] = _stack.back();
+						_stack.pop_back();
+						if (finish) {
+							_colour.assign(v, _black);
+							visitor.finish_vert(v);
+							continue;
+						}
+						// Edges are classified when followed rather than when pushed, since the vertex may have been discovered in between
+						switch (_colour(v)) {
+						case _grey:
+							visitor.back_edge(e);
+							continue;
+						case _black:
+							visitor.forward_or_cross_edge(e);
+							continue;
+						default:
+							break;
+						}
+						_discover(v);
+						if (!_is_null(e))
+							visitor.tree_edge(e);
+						visitor.discover_vert(v);
+						_stack.push_back(_frame{ v, Edges::null(g), true });
+						// Pushed in reverse so that edges are followed in order
+						auto first = _stack.size();
+						for (auto f : Adjacent_edges::range(g, v))
+							_stack.push_back(_frame{ traits::adjacency_cokey<Adjacency, G>(g, f), f, false });
+						std::reverse(_stack.begin() + first, _stack.end());
+					}
+				}
+
+				// Traverses breadth-first from `s` unless it has already been discovered, skipping vertices discovered by earlier traversals.
+				template <class Visitor>
+				void breadth_first_from(const Vert& s, Visitor&& visitor) {
+					const G& g = _g;
+					if (discovered(s))
+						return;
+					_discover(s);
+					visitor.discover_vert(s);
+					_queue.push_back(s);
+					for (std::size_t head = 0; head < _queue.size(); ++head) {
+						auto v = _queue[head];
+						for (auto e : Adjacent_edges::range(g, v)) {
+							auto u = traits::adjacency_cokey<Adjacency, G>(g, e);
+							if (discovered(u)) {
+								visitor.non_tree_edge(e);
+							} else {
+								_discover(u);
+								visitor.tree_edge(e);
+								visitor.discover_vert(u);
+								_queue.push_back(u);
+							}
+						}
+						_colour.assign(v, _black);
+						visitor.finish_vert(v);
+					}
+					_queue.clear();
+				}
+
+			private:
+				enum _colour_type : unsigned char { _white, _grey, _black };
+				struct _frame {
+					Vert v;
+					// Edge by which `v` is reached, or null for the root or a finish marker
+					Edge e;
+					bool finish;
+				};
+
+				bool _is_null(const Edge& e) const {
+					return e == Edges::null(_g);
+				}
+				void _discover(const Vert& v) {
+					_colour.assign(v, _grey);
+					_discovered.push_back(v);
+				}
+
+				std::reference_wrapper<const G> _g;
+				typename Verts::template ephemeral_map_type<_colour_type> _colour;
+				std::vector<Vert> _discovered;
+				std::vector<_frame> _stack;
+				std::vector<Vert> _queue;
+			};
+		}
+	}
+}
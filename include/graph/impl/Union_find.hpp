@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <limits>
+
+#include "exceptions.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		// Disjoint sets of dense indices which threads may find and unite concurrently without locks.
+		// Each set is rooted at its smallest element, so linking never creates a cycle however unions interleave, and finds halve the paths they traverse.
+		template <class Index = std::uint32_t>
+		class Union_find {
+		public:
+			using index_type = Index;
+
+			explicit Union_find(std::size_t size = 0) {
+				grow(size);
+			}
+
+			std::size_t size() const {
+				return _size;
+			}
+			// Adds singleton sets until there are `size` elements.  Not safe to call concurrently with anything else.
+			void grow(std::size_t size) {
+				if (size <= _size)
+					return;
+				impl::check_precondition(size <= std::size_t(std::numeric_limits<Index>::max()), "too many elements to index");
+				std::unique_ptr<std::atomic<Index>[]> parent(new std::atomic<Index>[size]);
+				for (std::size_t i = 0; i < _size; ++i)
+					parent[i].store(_parent[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+				for (std::size_t i = _size; i < size; ++i)
+					parent[i].store(static_cast<Index>(i), std::memory_order_relaxed);
+				_parent = std::move(parent);
+				_size = size;
+			}
+
+			// Smallest element of the set containing `i`
+			Index find(Index i) {
+				for (;;) {
+					auto p = _parent[i].load(std::memory_order_relaxed);
+					if (p == i)
+						return i;
+					auto gp = _parent[p].load(std::memory_order_relaxed);
+					if (gp == p)
+						return p;
+					// Path halving: losing this race only means another thread shortened the path first
+					_parent[i].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+					i = gp;
+				}
+			}
+			// Merges the sets containing `i` and `j`, returning whether they were distinct
+			bool unite(Index i, Index j) {
+				for (;;) {
+					i = find(i);
+					j = find(j);
+					if (i == j)
+						return false;
+					if (i < j)
+						std::swap(i, j);
+					// Link the larger root beneath the smaller, unless another thread has already linked it
+					auto expected = i;
+					if (_parent[i].compare_exchange_strong(expected, j, std::memory_order_relaxed))
+						return true;
+				}
+			}
+			// Whether `i` and `j` are in the same set; concurrent unions may make this stale
+			bool same(Index i, Index j) {
+				return find(i) == find(j);
+			}
+			// Points every element directly at its root, so that `parent` gives roots without searching.  Not safe to call concurrently with unions.
+			void compress() {
+				auto size = static_cast<std::ptrdiff_t>(_size);
+				#pragma omp parallel for schedule(static, 4096)
+				for (std::ptrdiff_t i = 0; i < size; ++i)
+					_parent[i].store(find(static_cast<Index>(i)), std::memory_order_relaxed);
+			}
+			// Parent of `i`, which is its root once compressed
+			Index parent(Index i) const {
+				return _parent[i].load(std::memory_order_relaxed);
+			}
+
+		private:
+			std::unique_ptr<std::atomic<Index>[]> _parent;
+			std::size_t _size = 0;
+		};
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+#include "Csr.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Dense square matrix indexed by pairs of vertices and stored row-major.
+			// Like `Dense_index`, it is a snapshot: it is undefined behavior to use it after vertices have been inserted or erased.
+			template <class G, class T>
+			class Vert_matrix {
+			public:
+				using Vert = typename Dense_index<G>::Vert;
+				using index_type = typename Dense_index<G>::index_type;
+
+				// Row of a matrix, mapping each vertex to the element in its column
+				class Row {
+				public:
+					Row(const Dense_index<G>* index, const T* data) :
+						_index(index), _data(data) {
+					}
+					const T& operator()(const Vert& v) const {
+						return _data[(*_index)(v)];
+					}
+					const T& operator[](const Vert& v) const {
+						return (*this)(v);
+					}
+				private:
+					const Dense_index<G>* _index;
+					const T* _data;
+				};
+
+				Vert_matrix(const G& g, const T& default_) :
+					_index(g),
+					_data(_index.size() * _index.size(), default_) {
+				}
+
+				std::size_t order() const {
+					return _index.size();
+				}
+				const Dense_index<G>& index() const {
+					return _index;
+				}
+
+				Row operator()(const Vert& s) const {
+					return Row(&_index, &_data[std::size_t(_index(s)) * order()]);
+				}
+				Row operator[](const Vert& s) const {
+					return (*this)(s);
+				}
+				const T& operator()(const Vert& s, const Vert& t) const {
+					return _data[std::size_t(_index(s)) * order() + _index(t)];
+				}
+
+				// Underlying row-major storage, indexed by `Dense_index`
+				T* data() {
+					return _data.data();
+				}
+				const T* data() const {
+					return _data.data();
+				}
+
+			private:
+				Dense_index<G> _index;
+				std::vector<T> _data;
+			};
+		}
+	}
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <stdexcept>
+#include <string>
+#include <initializer_list>
 
 #ifdef NDEBUG
 #	define GRAPH_CHECK_PRECONDITIONS 0
@@ -13,6 +15,12 @@ namespace graph {
 		class precondition_unmet : public std::logic_error {
 			using logic_error::logic_error;
 		};
+		struct format_error : std::runtime_error {
+			using _base_type = std::runtime_error;
+			format_error(std::initializer_list<const char *> expected, std::string found) :
+				_base_type(std::string("expected ") + *expected.begin() + ", found: " + found)
+			{}
+		};
 		namespace impl {
 			inline void check_precondition(bool condition, const char *message) {
 #if GRAPH_CHECK_PRECONDITIONS
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
+#include <exception>
+
+#include "impl/exceptions.hpp"
+#include "impl/omp.hpp"
+#include "impl/Csr.hpp"
+#include "impl/Vert_matrix.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Bellman-Ford from a virtual source with a zero weight edge to every vertex.  The resulting distances are potentials under which every edge has non-negative reduced weight.
+			template <class D, class G, class Weight>
+			std::vector<D> _johnson_potentials(const G& g, const Dense_index<G>& index, const Weight& weight) {
+				using Edges = traits::Edges<G>;
+				using index_type = typename Dense_index<G>::index_type;
+				struct arc {
+					index_type tail, head;
+					D weight;
+				};
+				std::vector<arc> arcs;
+				arcs.reserve(static_cast<std::size_t>(Edges::size(g)));
+				for (auto e : Edges::range(g))
+					arcs.push_back(arc{ index(Edges::tail(g, e)), index(Edges::head(g, e)), weight(e) });
+				auto n = index.size();
+				std::vector<D> potential(n, D{});
+				for (std::size_t round = 0; round <= n; ++round) {
+					bool changed = false;
+					for (const auto& a : arcs) {
+						auto c = potential[a.tail] + a.weight;
+						if (c < potential[a.head]) {
+							potential[a.head] = c;
+							changed = true;
+						}
+					}
+					if (!changed)
+						break;
+					if (round >= n)
+						throw precondition_unmet("graph must not contain negative cycles");
+				}
+				return potential;
+			}
+
+			// Runs Dijkstra's algorithm from every vertex in parallel, passing each row of distances to `row(s, distance)`, which may be called concurrently.
+			template <class D, class G, class Weight, class Row>
+			void _johnson(const G& g, const Dense_index<G>& index, const Weight& weight, const Row& row) {
+				static_assert(std::is_arithmetic_v<D>, "reweighting requires arithmetic weights");
+				using index_type = typename Dense_index<G>::index_type;
+				constexpr D inf = std::numeric_limits<D>::max();
+				auto n = index.size();
+				auto potential = _johnson_potentials<D>(g, index, weight);
+				Csr<traits::Out, G> out(g, index);
+				std::vector<D> reduced(out.edges().size());
+				for (index_type v = 0; v < n; ++v)
+					for (auto j = out.begin(v); j < out.end(v); ++j)
+						// clamped because rounding may leave floating point weights slightly negative
+						reduced[j] = std::max(D{}, weight(out.edge(j)) + potential[v] - potential[out.cokey(j)]);
+
+				auto sources = static_cast<std::ptrdiff_t>(n);
+				#pragma omp parallel
+				{
+					// Each thread reuses its workspace for every source it searches from
+					std::vector<D> distance(n, inf);
+					std::vector<index_type> touched;
+					std::vector<std::pair<D, index_type>> heap;
+					auto heap_compare = [](const auto& l, const auto& r) {
+						// arguments reversed because the standard heap algorithms build max heaps
+						return r.first < l.first;
+					};
+					#pragma omp for schedule(dynamic, 16)
+					for (std::ptrdiff_t i = 0; i < sources; ++i) {
+						auto s = static_cast<index_type>(i);
+						distance[s] = D{};
+						touched.push_back(s);
+						heap.emplace_back(D{}, s);
+						while (!heap.empty()) {
+							std::pop_heap(heap.begin(), heap.end(), heap_compare);
+							auto [d, v] = heap.back();
+							heap.pop_back();
+							if (distance[v] < d)
+								continue; // stale entry
+							for (auto j = out.begin(v); j < out.end(v); ++j) {
+								auto u = out.cokey(j);
+								auto c = d + reduced[j];
+								if (c < distance[u]) {
+									if (distance[u] == inf)
+										touched.push_back(u);
+									distance[u] = c;
+									heap.emplace_back(c, u);
+									std::push_heap(heap.begin(), heap.end(), heap_compare);
+								}
+							}
+						}
+						// Undo the reweighting
+						for (auto v : touched)
+							distance[v] = distance[v] - potential[s] + potential[v];
+						row(s, distance.data());
+						for (auto v : touched)
+							distance[v] = inf;
+						touched.clear();
+					}
+				}
+			}
+		}
+		template <class Impl>
+		template <class Weight>
+		auto Out_edge_graph<Impl>::all_pairs_shortest_paths_sparse(const Weight& weight) const {
+			using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
+			auto inf = std::numeric_limits<D>::max();
+
+			auto distance = impl::Vert_matrix<Impl, D>(this->_impl(), inf);
+			auto n = distance.order();
+			D* m = distance.data();
+			// Rows are disjoint, so they can be copied concurrently
+			impl::_johnson<D>(this->_impl(), distance.index(), weight,
+				[m, n](auto s, const D* row) { std::copy(row, row + n, m + std::size_t(s) * n); });
+			return distance;
+		}
+		template <class Impl>
+		template <class Weight, class Row>
+		void Out_edge_graph<Impl>::all_pairs_shortest_paths_sparse(const Weight& weight, Row&& row) const {
+			using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
+			using Matrix = impl::Vert_matrix<Impl, D>;
+
+			impl::Dense_index<Impl> index(this->_impl());
+			// Exceptions cannot escape the parallel region, so the first stops further calls and is rethrown after it
+			std::exception_ptr ex;
+			impl::_johnson<D>(this->_impl(), index, weight,
+				[&](auto s, const D* distance) {
+					#pragma omp critical(graph_all_pairs_shortest_paths_row)
+					if (!ex) {
+						try {
+							row(index[s], typename Matrix::Row(&index, distance));
+						} catch (...) {
+							ex = std::current_exception();
+						}
+					}
+				});
+			if (ex)
+				std::rethrow_exception(ex);
+		}
+	}
+}
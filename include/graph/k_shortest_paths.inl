@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <vector>
+#include <set>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include "impl/traits.hpp"
+#include "impl/exceptions.hpp"
+#include "impl/omp.hpp"
+#include "impl/Csr.hpp"
+#include "impl/Dijkstra_workspace.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Reusable workspace for Dijkstra searches over a dense snapshot of a graph with some vertices and edges masked out, as spur searches need
+			template <class G, class D>
+			class _masked_dijkstra {
+				using index_type = typename Dense_index<G>::index_type;
+			public:
+				_masked_dijkstra(const Csr<traits::Out, G>& out, const std::vector<D>& weight) :
+					_out(out), _weight(weight), _workspace(out.size()), _blocked(out.size(), 0) {
+				}
+
+				// Finds a shortest path from `s` to `t` avoiding the `blocked` vertices and the `banned` positions of edges out of `s`, appending the positions of its edges to `path` and returning its length, or `inf` if there is none
+				template <class Compare, class Combine>
+				D search(index_type s, index_type t,
+					const std::vector<index_type>& blocked, const std::vector<std::size_t>& banned,
+					std::vector<std::size_t>& path,
+					const Compare& compare, const Combine& combine, D zero, D inf) {
+					for (auto v : blocked)
+						_blocked[v] = 1;
+					auto unblock = [&] {
+						for (auto v : blocked)
+							_blocked[v] = 0;
+					};
+					try {
+						auto length = _search(s, t, banned, path, compare, combine, zero, inf);
+						unblock();
+						return length;
+					} catch (...) {
+						unblock();
+						throw;
+					}
+				}
+
+			private:
+				template <class Compare, class Combine>
+				D _search(index_type s, index_type t, const std::vector<std::size_t>& banned,
+					std::vector<std::size_t>& path,
+					const Compare& compare, const Combine& combine, D zero, D inf) {
+					_workspace.start(s, zero);
+					while (!_workspace.empty()) {
+						auto [d, v] = _workspace.pop(compare);
+						if (compare(_workspace.distance(v, inf), d))
+							continue; // stale entry
+						if (v == t) {
+							auto first = path.size();
+							for (auto u = t; u != s; u = _workspace.parent(u).first)
+								path.push_back(_workspace.parent(u).second);
+							std::reverse(path.begin() + first, path.end());
+							return d;
+						}
+						for (auto k = _out.begin(v); k < _out.end(v); ++k) {
+							auto u = _out.cokey(k);
+							if (_blocked[u])
+								continue;
+							if (v == s && std::find(banned.begin(), banned.end(), k) != banned.end())
+								continue;
+							auto c = combine(d, _weight[k]);
+							if (!_workspace.labelled(u) || compare(c, _workspace.distance(u, inf)))
+								_workspace.relax(u, c, v, k, compare);
+						}
+					}
+					return inf;
+				}
+
+				const Csr<traits::Out, G>& _out;
+				const std::vector<D>& _weight;
+				Dijkstra_workspace<index_type, D> _workspace;
+				// Vertices excluded from the current search, cleared again once it finishes
+				std::vector<std::uint8_t> _blocked;
+			};
+
+			// Yen's algorithm ("Finding the K Shortest Loopless Paths in a Network") with Lawler's refinement, which spurs only from where each path deviated from its parent, since earlier spurs repeat searches already made for the parent.
+			// The spur searches for each path are independent, so they run in parallel, each thread in its own workspace.
+			template <class G, class Weight, class Compare, class Combine, class D>
+			auto _k_shortest_paths(const G& g, Vert<G> source, Vert<G> target, std::size_t k, const Weight& weight,
+				const Compare& compare, const Combine& combine, D zero, D inf) {
+				using index_type = typename Dense_index<G>::index_type;
+				Dense_index<G> index(g);
+				Csr<traits::Out, G> out(g, index);
+				auto w = nonnegative_weights(out, weight, compare, combine, zero);
+
+				struct candidate {
+					D length;
+					// Positions of the edges of the path in the snapshot
+					std::vector<std::size_t> edges;
+					// Index of the first edge in which the path differs from the one it was spurred from
+					std::size_t deviation;
+				};
+				// Ordered by length, and otherwise by edges so that the same path found from different spurs is kept once
+				struct candidate_compare {
+					const Compare& compare;
+					bool operator()(const candidate& l, const candidate& r) const {
+						if (compare(l.length, r.length))
+							return true;
+						if (compare(r.length, l.length))
+							return false;
+						return l.edges < r.edges;
+					}
+				};
+				std::vector<candidate> accepted;
+				std::set<candidate, candidate_compare> candidates(candidate_compare{ compare });
+				auto to_edges = [&] {
+					std::vector<std::vector<typename traits::Edges<G>::value_type>> paths(accepted.size());
+					for (std::size_t i = 0; i < accepted.size(); ++i)
+						for (auto e : accepted[i].edges)
+							paths[i].push_back(out.edge(e));
+					return paths;
+				};
+				auto s = index(source), t = index(target);
+				if (k == 0)
+					return to_edges();
+				if (s == t) {
+					accepted.push_back(candidate{ zero, {}, 0 });
+					return to_edges();
+				}
+
+				std::vector<_masked_dijkstra<G, D>> workspaces;
+				workspaces.reserve(omp_get_max_threads());
+				for (int i = 0; i < omp_get_max_threads(); ++i)
+					workspaces.emplace_back(out, w);
+				{
+					candidate first{ zero, {}, 0 };
+					first.length = workspaces[0].search(s, t, {}, {}, first.edges, compare, combine, zero, inf);
+					if (first.length == inf)
+						return to_edges();
+					accepted.push_back(std::move(first));
+				}
+				std::vector<index_type> verts;
+				std::vector<D> prefix;
+				std::vector<candidate> spurs;
+				while (accepted.size() < k) {
+					// Vertices along the last accepted path and the lengths of its prefixes
+					const auto& last = accepted.back();
+					verts.assign(1, s);
+					prefix.assign(1, zero);
+					for (auto e : last.edges) {
+						verts.push_back(out.cokey(e));
+						prefix.push_back(combine(prefix.back(), w[e]));
+					}
+					auto first = static_cast<std::ptrdiff_t>(last.deviation), end = static_cast<std::ptrdiff_t>(last.edges.size());
+					spurs.assign(last.edges.size(), candidate{ inf, {}, 0 });
+					// Exceptions cannot escape the parallel region, so the first is rethrown after it
+					std::exception_ptr ex;
+					#pragma omp parallel
+					{
+						auto& workspace = workspaces[omp_get_thread_num()];
+						std::vector<index_type> blocked;
+						std::vector<std::size_t> banned;
+						#pragma omp for schedule(dynamic, 1)
+						for (std::ptrdiff_t i = first; i < end; ++i) {
+							try {
+								// The root must stay loopless, and must not continue as any accepted path sharing it does
+								blocked.assign(verts.begin(), verts.begin() + i);
+								banned.clear();
+								for (const auto& path : accepted)
+									if (path.edges.size() > static_cast<std::size_t>(i) &&
+										std::equal(last.edges.begin(), last.edges.begin() + i, path.edges.begin()))
+										banned.push_back(path.edges[i]);
+								auto& spur = spurs[i];
+								spur.edges.assign(last.edges.begin(), last.edges.begin() + i);
+								auto length = workspace.search(verts[i], t, blocked, banned, spur.edges, compare, combine, zero, inf);
+								if (length != inf) {
+									spur.length = combine(prefix[i], length);
+									spur.deviation = static_cast<std::size_t>(i);
+								}
+							} catch (...) {
+								#pragma omp critical(graph_k_shortest_paths_exception)
+								if (!ex)
+									ex = std::current_exception();
+							}
+						}
+					}
+					if (ex)
+						std::rethrow_exception(ex);
+					for (auto& spur : spurs)
+						if (spur.length != inf)
+							candidates.insert(std::move(spur));
+					if (candidates.empty())
+						break;
+					accepted.push_back(std::move(candidates.extract(candidates.begin()).value()));
+				}
+				return to_edges();
+			}
+		}
+		template <class Impl>
+		template <class Weight, class Compare, class Combine>
+		auto Out_edge_graph<Impl>::k_shortest_paths(const Vert& s, const Vert& t, std::size_t k, const Weight& weight,
+			const Compare& compare, const Combine& combine) const {
+			// TODO: Convert these to parameters
+			using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
+			auto zero = D{}, inf = std::numeric_limits<D>::max();
+
+			std::vector<typename _base_type::Path> paths;
+			for (auto& edges : impl::_k_shortest_paths(this->_impl(), s, t, k, weight, compare, combine, zero, inf))
+				paths.push_back(this->path(s, std::move(edges)));
+			return paths;
+		}
+	}
+}
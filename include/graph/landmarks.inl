@@ -0,0 +1,17 @@
+#pragma once
+
+#include <limits>
+#include <type_traits>
+
+#include "impl/Landmarks.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		template <class Impl>
+		template <class Weight, class Random>
+		auto Bi_edge_graph<Impl>::landmarks(const Weight& weight, std::size_t k, Random& random) const {
+			using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
+			return impl::Landmarks<Impl, D>(this->_impl(), weight, k, random);
+		}
+	}
+}
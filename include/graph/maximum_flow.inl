@@ -0,0 +1,224 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <type_traits>
+
+#include "impl/traits.hpp"
+#include "impl/exceptions.hpp"
+#include "impl/Csr.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Highest-label push-relabel (Goldberg and Tarjan, "A New Approach to the Maximum-Flow Problem"), with the heuristics of Cherkassky and Goldberg, "On Implementing Push-Relabel Method for the Maximum Flow Problem":
+			// when no vertex is left with some label, those above it can no longer reach the sink, and labels are periodically reset to exact distances in the residual graph.
+			// Excess which cannot reach the sink is returned to the source in the same loop, with labels above the order of the graph, so the result is a flow rather than a preflow.
+			template <class G, class Capacity>
+			auto _maximum_flow(const G& g, const Vert<G>& source, const Vert<G>& sink, const Capacity& capacity) {
+				using Verts = traits::Verts<G>;
+				using Edges = traits::Edges<G>;
+				using index_type = typename Dense_index<G>::index_type;
+				using C = std::decay_t<std::result_of_t<const Capacity&(typename Edges::value_type)>>;
+				check_precondition(source != sink, "source and sink must differ");
+				Dense_index<G> index(g);
+				auto n = index.size();
+				auto s = index(source), t = index(sink);
+
+				// Residual arcs in pairs, so the reverse of arc `a` is `a ^ 1`; edge `k` gives arc `2 k` forward and `2 k + 1` back
+				std::vector<typename Edges::value_type> edges;
+				std::vector<index_type> heads;
+				std::vector<C> residual;
+				std::vector<std::size_t> offsets(n + 1, 0);
+				for (auto e : Edges::range(g)) {
+					auto c = capacity(e);
+					check_precondition(!(c < C{}), "capacities must be non-negative");
+					auto u = index(Edges::tail(g, e)), v = index(Edges::head(g, e));
+					edges.push_back(e);
+					heads.push_back(v);
+					heads.push_back(u);
+					residual.push_back(c);
+					residual.push_back(C{});
+					++offsets[u + 1];
+					++offsets[v + 1];
+				}
+				for (std::size_t v = 0; v < n; ++v)
+					offsets[v + 1] += offsets[v];
+				// Arcs leaving each vertex, contiguously
+				std::vector<std::size_t> arcs(heads.size());
+				{
+					auto next = offsets;
+					for (std::size_t a = 0; a < heads.size(); ++a)
+						arcs[next[heads[a ^ 1]]++] = a;
+				}
+
+				// Labels below `n` bound the distance to the sink, and labels from `n` bound the distance to the source plus `n`
+				const std::size_t unreachable = 2 * n;
+				std::vector<std::size_t> label(n, 0), current(n), count(2 * n + 1, 0);
+				std::vector<C> excess(n, C{});
+				// Every vertex but the source and sink with a label below `unreachable` is in the list for its label, active if it has excess and inactive otherwise.
+				// The lists are doubly linked through the vertices, so a vertex moves between them in constant time and a gap visits only the vertices above it.
+				constexpr auto none = Dense_index<G>::null_index;
+				std::vector<index_type> next(n, none), prev(n, none);
+				std::vector<index_type> active(2 * n, none), inactive(2 * n, none);
+				std::vector<unsigned char> is_active(n, 0);
+				// Highest label with an active vertex, and a bound on the highest label below `n` of any listed vertex
+				std::size_t highest = 0, highest_listed = 0;
+				auto listed = [&](index_type v) {
+					return v != s && v != t && label[v] < unreachable;
+				};
+				auto link = [&](index_type v) {
+					is_active[v] = excess[v] > C{};
+					auto& head = (is_active[v] ? active : inactive)[label[v]];
+					prev[v] = none;
+					next[v] = head;
+					if (head != none)
+						prev[head] = v;
+					head = v;
+					if (is_active[v])
+						highest = std::max(highest, label[v]);
+					if (label[v] < n)
+						highest_listed = std::max(highest_listed, label[v]);
+				};
+				auto unlink = [&](index_type v) {
+					auto& head = (is_active[v] ? active : inactive)[label[v]];
+					if (prev[v] != none)
+						next[prev[v]] = next[v];
+					else
+						head = next[v];
+					if (next[v] != none)
+						prev[next[v]] = prev[v];
+				};
+				// Exact labels by breadth-first search backward along residual arcs, first from the sink and then from the source
+				std::vector<index_type> queue;
+				auto global_relabel = [&] {
+					std::fill(label.begin(), label.end(), unreachable);
+					std::fill(count.begin(), count.end(), 0);
+					std::fill(active.begin(), active.end(), none);
+					std::fill(inactive.begin(), inactive.end(), none);
+					highest = highest_listed = 0;
+					for (auto [root, base] : { std::pair(t, std::size_t{}), std::pair(s, n) }) {
+						queue.assign(1, root);
+						label[root] = base;
+						for (std::size_t head = 0; head < queue.size(); ++head) {
+							auto v = queue[head];
+							for (auto i = offsets[v]; i < offsets[v + 1]; ++i) {
+								auto a = arcs[i];
+								auto u = heads[a];
+								if (label[u] == unreachable && residual[a ^ 1] > C{}) {
+									label[u] = label[v] + 1;
+									queue.push_back(u);
+								}
+							}
+						}
+					}
+					for (index_type v = 0; v < n; ++v) {
+						++count[label[v]];
+						current[v] = offsets[v];
+						if (listed(v))
+							link(v);
+					}
+				};
+				auto set_label = [&](index_type v, std::size_t l) {
+					--count[label[v]];
+					label[v] = l;
+					++count[l];
+					current[v] = offsets[v];
+				};
+
+				for (auto i = offsets[s]; i < offsets[s + 1]; ++i) {
+					auto a = arcs[i];
+					auto c = residual[a];
+					residual[a] -= c;
+					residual[a ^ 1] += c;
+					excess[heads[a]] += c;
+					excess[s] -= c;
+				}
+				global_relabel();
+				// Work between global relabelings, as suggested by Cherkassky and Goldberg
+				const std::size_t period = 6 * n + heads.size() / 2;
+				std::size_t work = 0;
+				for (;;) {
+					while (highest > 0 && active[highest] == none)
+						--highest;
+					if (active[highest] == none)
+						break;
+					// Discharge `v`, pushing along admissible arcs and relabelling when there are none
+					auto v = active[highest];
+					unlink(v);
+					while (excess[v] > C{}) {
+						if (current[v] == offsets[v + 1]) {
+							auto old = label[v];
+							auto relabelled = unreachable;
+							for (auto i = offsets[v]; i < offsets[v + 1]; ++i)
+								if (residual[arcs[i]] > C{})
+									relabelled = std::min(relabelled, label[heads[arcs[i]]] + 1);
+							work += offsets[v + 1] - offsets[v] + 12;
+							set_label(v, relabelled);
+							if (old < n && count[old] == 0) {
+								// Gap: everything labelled above `old` has lost its way to the sink
+								for (auto l = old + 1; l <= highest_listed && l < n; ++l) {
+									for (auto* list : { &active, &inactive }) {
+										for (auto u = (*list)[l]; u != none;) {
+											auto following = next[u];
+											set_label(u, n + 1);
+											link(u);
+											u = following;
+										}
+										(*list)[l] = none;
+									}
+								}
+								highest_listed = old;
+								if (label[v] < n)
+									set_label(v, n + 1);
+							}
+							if (label[v] >= unreachable)
+								break;
+							continue;
+						}
+						auto a = arcs[current[v]];
+						auto u = heads[a];
+						if (residual[a] > C{} && label[v] == label[u] + 1) {
+							auto delta = std::min(excess[v], residual[a]);
+							residual[a] -= delta;
+							residual[a ^ 1] += delta;
+							excess[v] -= delta;
+							auto activated = listed(u) && !is_active[u];
+							if (activated)
+								unlink(u);
+							excess[u] += delta;
+							if (activated)
+								link(u);
+						} else {
+							++current[v];
+						}
+					}
+					if (listed(v))
+						link(v);
+					if (work > period) {
+						work = 0;
+						global_relabel();
+					}
+				}
+
+				// The source side of a minimum cut is everything that cannot reach the sink in the residual graph
+				global_relabel();
+				auto cut = Verts::set(g);
+				for (index_type v = 0; v < n; ++v)
+					if (label[v] >= n)
+						cut.insert(index[v]);
+				auto flow = Edges::map(g, C{});
+				for (std::size_t k = 0; k < edges.size(); ++k)
+					flow.assign(edges[k], residual[2 * k + 1]);
+				return std::tuple(excess[t], std::move(flow), std::move(cut));
+			}
+		}
+		template <class Impl>
+		template <class Capacity>
+		auto Graph<Impl>::maximum_flow(const Vert& s, const Vert& t, const Capacity& capacity) const {
+			return impl::_maximum_flow(this->_impl(), s, t, capacity);
+		}
+	}
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <utility>
+#include <exception>
+
+#include "impl/traits.hpp"
+#include "impl/omp.hpp"
+#include "impl/Csr.hpp"
+#include "impl/Union_find.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Flat snapshot of the edges of a graph with their weights, shared by the spanning forest algorithms.
+			// Edges are ordered by weight and then by position, so that ties are broken consistently and the lightest edge leaving any set of vertices is unique.
+			template <class G, class Weight, class Compare>
+			struct _weighted_edges {
+				using Edges = traits::Edges<G>;
+				using Edge = typename Edges::value_type;
+				using index_type = typename Dense_index<G>::index_type;
+				using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
+
+				_weighted_edges(const G& g, const Dense_index<G>& index, const Weight& weight, const Compare& compare) :
+					compare(compare) {
+					auto m = static_cast<std::size_t>(Edges::size(g));
+					check_precondition(m < Dense_index<G>::null_index, "too many edges to index");
+					edges.reserve(m);
+					ends.reserve(m);
+					weights.reserve(m);
+					for (auto e : Edges::range(g)) {
+						edges.push_back(e);
+						ends.emplace_back(index(Edges::tail(g, e)), index(Edges::head(g, e)));
+						weights.push_back(weight(e));
+					}
+				}
+
+				std::size_t size() const {
+					return edges.size();
+				}
+				bool lighter(index_type k, index_type l) const {
+					if (compare(weights[k], weights[l]))
+						return true;
+					if (compare(weights[l], weights[k]))
+						return false;
+					return k < l;
+				}
+
+				const Compare& compare;
+				std::vector<Edge> edges;
+				std::vector<std::pair<index_type, index_type>> ends;
+				std::vector<D> weights;
+			};
+
+			// Boruvka's algorithm: every component selects its lightest adjacent edge in parallel by atomic minimum, and the selected edges are contracted in a concurrent union-find.  Each round at least halves the number of components.
+			template <class G, class Weight, class Compare>
+			auto _boruvka(const G& g, const Weight& weight, const Compare& compare) {
+				using index_type = typename Dense_index<G>::index_type;
+				constexpr auto none = Dense_index<G>::null_index;
+				Dense_index<G> index(g);
+				_weighted_edges<G, Weight, Compare> edges(g, index, weight, compare);
+				auto n = static_cast<std::ptrdiff_t>(index.size());
+				Union_find<index_type> sets(index.size());
+				std::vector<std::atomic<index_type>> lightest(index.size());
+				#pragma omp parallel for schedule(static, 4096)
+				for (std::ptrdiff_t i = 0; i < n; ++i)
+					lightest[i].store(none, std::memory_order_relaxed);
+
+				std::vector<index_type> active, next;
+				for (index_type k = 0; k < edges.size(); ++k)
+					if (edges.ends[k].first != edges.ends[k].second)
+						active.push_back(k);
+				std::vector<typename traits::Edges<G>::value_type> forest;
+				while (!active.empty()) {
+					// Select the lightest edge leaving each component, dropping edges within components
+					auto size = static_cast<std::ptrdiff_t>(active.size());
+					next.clear();
+					#pragma omp parallel
+					{
+						std::vector<index_type> local;
+						#pragma omp for schedule(static, 4096) nowait
+						for (std::ptrdiff_t i = 0; i < size; ++i) {
+							auto k = active[i];
+							auto ru = sets.parent(edges.ends[k].first), rv = sets.parent(edges.ends[k].second);
+							if (ru == rv)
+								continue;
+							local.push_back(k);
+							for (auto r : { ru, rv }) {
+								auto l = lightest[r].load(std::memory_order_relaxed);
+								while ((l == none || edges.lighter(k, l)) &&
+									!lightest[r].compare_exchange_weak(l, k, std::memory_order_relaxed))
+									;
+							}
+						}
+						#pragma omp critical
+						next.insert(next.end(), local.begin(), local.end());
+					}
+					std::swap(active, next);
+					// Contract the selected edges.  They form a forest, so a union fails only for an edge selected from both of its ends.
+					#pragma omp parallel
+					{
+						std::vector<typename traits::Edges<G>::value_type> local;
+						#pragma omp for schedule(static, 4096) nowait
+						for (std::ptrdiff_t i = 0; i < n; ++i) {
+							auto k = lightest[i].load(std::memory_order_relaxed);
+							if (k == none)
+								continue;
+							lightest[i].store(none, std::memory_order_relaxed);
+							if (sets.unite(edges.ends[k].first, edges.ends[k].second))
+								local.push_back(edges.edges[k]);
+						}
+						#pragma omp critical
+						forest.insert(forest.end(), local.begin(), local.end());
+					}
+					sets.compress();
+				}
+				return forest;
+			}
+
+			// Filter-Kruskal (Osipov et al., "The Filter-Kruskal Minimum Spanning Tree Algorithm"): edges are partitioned around a pivot weight as in quicksort, the lighter part is processed first, and the heavier part is then filtered of edges already within a component as it is partitioned further.
+			// Large parts are filtered and partitioned together in parallel, so the sort is parallel down to the small parts, which are sorted serially as Kruskal's algorithm consumes them.
+			template <class G, class Weight, class Compare>
+			auto _filter_kruskal(const G& g, const Weight& weight, const Compare& compare) {
+				using index_type = typename Dense_index<G>::index_type;
+				// Parts no larger than this are sorted rather than partitioned
+				constexpr std::size_t threshold = 256;
+				// Parts at least this large are filtered and partitioned in parallel
+				constexpr std::size_t parallel_threshold = 1 << 14;
+				Dense_index<G> index(g);
+				_weighted_edges<G, Weight, Compare> edges(g, index, weight, compare);
+				Union_find<index_type> sets(index.size());
+				auto lighter = [&](index_type k, index_type l) { return edges.lighter(k, l); };
+				auto spanned = [&](index_type k) {
+					auto [u, v] = edges.ends[k];
+					return sets.find(u) == sets.find(v);
+				};
+
+				std::vector<index_type> ids(edges.size()), scratch;
+				for (index_type k = 0; k < edges.size(); ++k)
+					ids[k] = k;
+				std::vector<typename traits::Edges<G>::value_type> forest;
+				// Parts still to be processed, lightest on top
+				std::vector<std::pair<std::size_t, std::size_t>> parts{ { 0, ids.size() } };
+				// Number of edges each thread keeps lighter than and not lighter than the pivot, then where it places them
+				std::vector<std::size_t> light(omp_get_max_threads() + 1), heavy(omp_get_max_threads() + 1);
+				while (!parts.empty()) {
+					auto [first, last] = parts.back();
+					parts.pop_back();
+					auto begin = ids.begin() + first, end = ids.begin() + last;
+					if (last - first <= threshold) {
+						end = std::remove_if(begin, end, spanned);
+						std::sort(begin, end, lighter);
+						for (auto it = begin; it != end; ++it)
+							if (sets.unite(edges.ends[*it].first, edges.ends[*it].second))
+								forest.push_back(edges.edges[*it]);
+						continue;
+					}
+					// The median of three distinct edges has a lighter one, so partitioning a part with no spanned edges leaves neither side empty
+					index_type sample[] = { *begin, *(begin + (end - begin) / 2), *(end - 1) };
+					std::sort(std::begin(sample), std::end(sample), lighter);
+					auto pivot = sample[1];
+					auto is_light = [&](index_type k) { return lighter(k, pivot); };
+					std::size_t middle;
+					if (last - first < parallel_threshold) {
+						end = std::remove_if(begin, end, spanned);
+						middle = std::partition(begin, end, is_light) - ids.begin();
+						last = end - ids.begin();
+					} else {
+						// Each thread counts what it keeps of a contiguous block, then scatters it stably into place
+						scratch.resize(last - first);
+						std::size_t used = 1;
+						std::exception_ptr ex;
+						#pragma omp parallel
+						{
+							auto thread = static_cast<std::size_t>(omp_get_thread_num()), threads = static_cast<std::size_t>(omp_get_num_threads());
+							auto lo = first + (last - first) * thread / threads, hi = first + (last - first) * (thread + 1) / threads;
+							std::vector<unsigned char> side(hi - lo);
+							std::size_t l = 0, h = 0;
+							try {
+								for (auto i = lo; i < hi; ++i) {
+									side[i - lo] = spanned(ids[i]) ? 0 : is_light(ids[i]) ? 1 : 2;
+									l += side[i - lo] == 1;
+									h += side[i - lo] == 2;
+								}
+							} catch (...) {
+								#pragma omp critical(graph_filter_kruskal_exception)
+								if (!ex)
+									ex = std::current_exception();
+								std::fill(side.begin(), side.end(), 0);
+								l = h = 0;
+							}
+							light[thread + 1] = l;
+							heavy[thread + 1] = h;
+							#pragma omp barrier
+							#pragma omp single
+							{
+								used = threads;
+								light[0] = 0;
+								for (std::size_t i = 0; i < threads; ++i)
+									light[i + 1] += light[i];
+								heavy[0] = light[threads];
+								for (std::size_t i = 0; i < threads; ++i)
+									heavy[i + 1] += heavy[i];
+							}
+							l = light[thread];
+							h = heavy[thread];
+							for (auto i = lo; i < hi; ++i) {
+								if (side[i - lo] == 1)
+									scratch[l++] = ids[i];
+								else if (side[i - lo] == 2)
+									scratch[h++] = ids[i];
+							}
+						}
+						if (ex)
+							std::rethrow_exception(ex);
+						middle = first + light[used];
+						last = first + heavy[used];
+						auto kept = static_cast<std::ptrdiff_t>(heavy[used]);
+						#pragma omp parallel for schedule(static)
+						for (std::ptrdiff_t i = 0; i < kept; ++i)
+							ids[first + i] = scratch[i];
+					}
+					parts.emplace_back(middle, last);
+					parts.emplace_back(first, middle);
+				}
+				return forest;
+			}
+		}
+		template <class Impl>
+		template <class Weight, class Compare>
+		auto Graph<Impl>::minimum_spanning_forest(const Weight& weight, const Compare& compare) const {
+			return impl::_boruvka(this->_impl(), weight, compare);
+		}
+		template <class Impl>
+		template <class Weight, class Compare>
+		auto Graph<Impl>::minimum_spanning_forest_kruskal(const Weight& weight, const Compare& compare) const {
+			return impl::_filter_kruskal(this->_impl(), weight, compare);
+		}
+	}
+}
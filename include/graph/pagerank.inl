@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+
+#include "impl/traits.hpp"
+#include "impl/exceptions.hpp"
+#include "impl/omp.hpp"
+#include "impl/Csr.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Power iteration for PageRank over a snapshot, stopping once the ranks change by less than `tolerance` in total.  The ranks of vertices without out-edges are spread evenly over every vertex.
+			// If `Pull`, each vertex gathers the ranks along its in-edges, so no two threads write the same rank; otherwise each vertex scatters its rank along its out-edges with atomic additions.
+			template <bool Pull, class G>
+			auto _pagerank(const G& g, double damping, double tolerance) {
+				using Verts = traits::Verts<G>;
+				using Adjacency = std::conditional_t<Pull, traits::In, traits::Out>;
+				check_precondition(0 <= damping && damping < 1, "damping must be in [0, 1)");
+				check_precondition(tolerance > 0, "tolerance must be positive");
+				Dense_index<G> index(g);
+				Csr<Adjacency, G> csr(g, index);
+				auto n = static_cast<std::ptrdiff_t>(index.size());
+				auto ranks = Verts::map(g, 0.0);
+				if (n == 0)
+					return ranks;
+
+				// Reciprocal out-degrees, or zero for dangling vertices, so the inner loops only multiply
+				std::vector<double> inverse_degree(index.size());
+				#pragma omp parallel for schedule(static, 4096)
+				for (std::ptrdiff_t i = 0; i < n; ++i) {
+					auto v = static_cast<typename Dense_index<G>::index_type>(i);
+					std::size_t degree;
+					if constexpr (Pull)
+						degree = static_cast<std::size_t>(traits::Out_edges<G>::size(g, index[v]));
+					else
+						degree = csr.end(v) - csr.begin(v);
+					inverse_degree[i] = degree ? 1.0 / degree : 0.0;
+				}
+				std::vector<double> rank(index.size(), 1.0 / n), share(index.size()), next(index.size());
+				for (double change = tolerance; !(change < tolerance);) {
+					double dangling = 0;
+					#pragma omp parallel for schedule(static, 4096) reduction(+: dangling)
+					for (std::ptrdiff_t i = 0; i < n; ++i) {
+						share[i] = damping * rank[i] * inverse_degree[i];
+						if (inverse_degree[i] == 0)
+							dangling += rank[i];
+					}
+					auto base = (1 - damping + damping * dangling) / n;
+					if constexpr (Pull) {
+						#pragma omp parallel for schedule(dynamic, 1024)
+						for (std::ptrdiff_t i = 0; i < n; ++i) {
+							auto v = static_cast<typename Dense_index<G>::index_type>(i);
+							double sum = base;
+							for (auto k = csr.begin(v); k < csr.end(v); ++k)
+								sum += share[csr.cokey(k)];
+							next[i] = sum;
+						}
+					} else {
+						std::fill(next.begin(), next.end(), base);
+						#pragma omp parallel for schedule(dynamic, 1024)
+						for (std::ptrdiff_t i = 0; i < n; ++i) {
+							auto v = static_cast<typename Dense_index<G>::index_type>(i);
+							auto s = share[i];
+							for (auto k = csr.begin(v); k < csr.end(v); ++k) {
+								auto& r = next[csr.cokey(k)];
+								#pragma omp atomic
+								r += s;
+							}
+						}
+					}
+					change = 0;
+					#pragma omp parallel for schedule(static, 4096) reduction(+: change)
+					for (std::ptrdiff_t i = 0; i < n; ++i)
+						change += std::abs(next[i] - rank[i]);
+					std::swap(rank, next);
+				}
+				for (std::ptrdiff_t i = 0; i < n; ++i)
+					ranks.assign(index[static_cast<typename Dense_index<G>::index_type>(i)], rank[i]);
+				return ranks;
+			}
+
+			// Approximate personalized PageRank by local pushes (Andersen, Chung, and Lang, "Local Graph Partitioning using PageRank Vectors").
+			// Probability mass not yet settled is kept as a residual, and a vertex pushes its residual to its out-neighbors only while it is at least `epsilon` per out-edge, so only the neighborhood of `s` with significant rank is ever touched.  Mass reaching a vertex without out-edges returns to `s`.
+			template <class G>
+			auto _personalized_pagerank(const G& g, const Vert<G>& s, double damping, double epsilon) {
+				using Edges = traits::Edges<G>;
+				using Out_edges = traits::Out_edges<G>;
+				using Vert = typename traits::Verts<G>::value_type;
+				check_precondition(0 <= damping && damping < 1, "damping must be in [0, 1)");
+				check_precondition(epsilon > 0, "epsilon must be positive");
+				std::unordered_map<Vert, double> rank, residual;
+				std::vector<Vert> queue;
+				auto threshold = [&](const Vert& v) {
+					return epsilon * static_cast<double>(std::max<std::size_t>(1, static_cast<std::size_t>(Out_edges::size(g, v))));
+				};
+				// Adds to a residual, queueing the vertex when it first reaches the threshold
+				auto add = [&](const Vert& v, double mass) {
+					auto& r = residual[v];
+					auto t = threshold(v);
+					if (r < t && r + mass >= t)
+						queue.push_back(v);
+					r += mass;
+				};
+				add(s, 1.0);
+				// First in, first out, so that residuals accumulate before they are pushed
+				for (std::size_t head = 0; head < queue.size(); ++head) {
+					auto v = queue[head];
+					auto r = std::exchange(residual[v], 0.0);
+					rank[v] += (1 - damping) * r;
+					auto degree = static_cast<std::size_t>(Out_edges::size(g, v));
+					if (degree == 0) {
+						add(s, damping * r);
+						continue;
+					}
+					auto share = damping * r / degree;
+					for (auto e : Out_edges::range(g, v))
+						add(Edges::head(g, e), share);
+				}
+				// Highest ranks first
+				std::vector<std::pair<Vert, double>> result(rank.begin(), rank.end());
+				std::sort(result.begin(), result.end(), [](const auto& l, const auto& r) {
+					return l.second > r.second || (l.second == r.second && l.first < r.first);
+				});
+				return result;
+			}
+		}
+		template <class Impl>
+		auto Out_edge_graph<Impl>::pagerank(double damping, double tolerance) const {
+			return impl::_pagerank<false>(this->_impl(), damping, tolerance);
+		}
+		template <class Impl>
+		auto Bi_edge_graph<Impl>::pagerank(double damping, double tolerance) const {
+			return impl::_pagerank<true>(this->_impl(), damping, tolerance);
+		}
+		template <class Impl>
+		auto Out_edge_graph<Impl>::personalized_pagerank(const Vert& s, double damping, double epsilon) const {
+			return impl::_personalized_pagerank(this->_impl(), s, damping, epsilon);
+		}
+	}
+}
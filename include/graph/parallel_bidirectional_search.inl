@@ -3,72 +3,108 @@
 #include "impl/omp.hpp"
 #ifdef _OPENMP
 
+#include <cstddef>
 #include <limits>
 #include <functional>
-#include <algorithm>
 #include <exception>
 #include <queue>
 #include <vector>
-#include <cassert>
 #include <atomic>
+#include <utility>
 
-#include <range/v3/algorithm/min.hpp>
-
+#include "impl/traits.hpp"
 #include "impl/exceptions.hpp"
 
 namespace graph {
 	inline namespace v1 {
 		namespace impl {
-			// This is identical to _bidirectional_search_step except that `near` and `far` closed sets are accessed atomically (and so must be maps to flags rather than sets)
-			template <class Adjacency, class G, class Queue,
-				class Near, class Far,
-				class Weight, class Distance, class Tree,
-				class Compare, class Combine>
-			bool _atomic_bidirectional_search_step(const G& g, Queue& queue,
-				Near& near, const Far& far,
-				const Weight& weight, Distance& distance, Tree& tree,
-				const Compare& compare, const Combine& combine) {
-				auto [d, v] = queue.top();
-				queue.pop();
-				// this read doesn't need to be atomic because only this thread writes to `near`
-				if (!near(v)) {
+			// One direction of a parallel bidirectional search, owned by a single task.  Its distances are written only by that task, atomically, so the other direction may read them to find where the two searches meet.
+			template <class Adjacency, class G, class Queue, class Weight, class Distance, class Tree, class D>
+			struct _parallel_bidirectional_search_side {
+				using Edge = typename traits::Edges<G>::value_type;
+				// Vertices with at least this many edges have them examined by a loop of tasks, which idle threads pick up
+				static constexpr std::size_t parallel_degree = 1024;
 
-					// `std::atomic_store(&near[v], true, std::memory_order_relaxed);`
-					auto& near_v = near[v];
-					#pragma omp atomic write
-					near_v = true;
+				const G& g;
+				Queue queue;
+				const Weight& weight;
+				Distance& distance;
+				Tree& tree;
+				// Distance of the nearest unsettled vertex, published after each step, or infinity once the queue is empty
+				std::atomic<D> top;
+				// Workspace for examining the edges of high-degree vertices
+				std::vector<Edge> edges;
+				std::vector<D> candidates;
+				std::vector<unsigned char> improves;
 
-					// auto done = `std::atomic_load(&far(v), std::memory_order_relaxed);`
-					const auto& far_v = far(v);
-					bool done;
-					#pragma omp atomic read
-					done = far_v;
+				_parallel_bidirectional_search_side(const G& g, Queue queue, const Weight& weight, Distance& distance, Tree& tree, D top) :
+					g(g),
+					queue(std::move(queue)),
+					weight(weight),
+					distance(distance),
+					tree(tree),
+					top(top) {
+				}
 
-					if (done)
-						return true;
-					for (auto e : traits::Adjacent_edges<Adjacency, G>::range(g, v)) {
-						auto u = traits::adjacency_cokey<Adjacency, G>(g, e);
-#ifdef NDEBUG
-						// optimization not required for correctness but skips checks below
-						if (near(u))
-							continue;
-#endif
-						auto c = combine(d, weight(e));
+				// Settles the nearest vertex, calling `label(u, c)` with each vertex whose distance it lowers
+				template <class Compare, class Combine, class Label>
+				void step(const Compare& compare, const Combine& combine, D inf, const Label& label) {
+					auto [d, v] = queue.top();
+					queue.pop();
+					// Each vertex is queued once per improvement, so only its last entry is current
+					if (compare(distance(v), d))
+						return _publish(inf);
+					auto relax = [&](const Edge& e, const D& c) {
 #ifndef NDEBUG
 						if (compare(c, d))
 							throw precondition_unmet("negative weight edge");
 #endif
-						decltype(auto) du = distance[u];
+						auto u = traits::adjacency_cokey<Adjacency, G>(g, e);
+						auto& du = distance[u];
 						if (compare(c, du)) {
-							assert(!near(u)); // sanity check which should never fail
+							#pragma omp atomic write seq_cst
 							du = c;
 							tree.insert_edge(e); // replace the old edge in the tree
 							queue.emplace(c, u);
+							label(u, c);
+						}
+					};
+					using Adjacent_edges = traits::Adjacent_edges<Adjacency, G>;
+					if (static_cast<std::size_t>(Adjacent_edges::size(g, v)) < parallel_degree) {
+						for (auto e : Adjacent_edges::range(g, v))
+							relax(e, combine(d, weight(e)));
+					} else {
+						// Weigh the edges in parallel, leaving only those which improve a distance to be applied in order
+						edges.assign(Adjacent_edges::range(g, v).begin(), Adjacent_edges::range(g, v).end());
+						auto size = static_cast<std::ptrdiff_t>(edges.size());
+						candidates.resize(edges.size());
+						improves.resize(edges.size());
+						// Exceptions cannot escape a task, so the first is rethrown once the loop completes
+						std::exception_ptr ex;
+						#pragma omp taskloop grainsize(256) shared(ex)
+						for (std::ptrdiff_t i = 0; i < size; ++i) {
+							try {
+								candidates[i] = combine(d, weight(edges[i]));
+								improves[i] = compare(candidates[i], distance(traits::adjacency_cokey<Adjacency, G>(g, edges[i])));
+							} catch (...) {
+								improves[i] = false;
+								#pragma omp critical(graph_parallel_shortest_path_exception)
+								if (!ex)
+									ex = std::current_exception();
+							}
 						}
+						if (ex)
+							std::rethrow_exception(ex);
+						for (std::ptrdiff_t i = 0; i < size; ++i)
+							if (improves[i])
+								relax(edges[i], candidates[i]);
 					}
+					_publish(inf);
 				}
-				return false;
-			}
+				void _publish(D inf) {
+					top.store(queue.empty() ? inf : queue.top().first);
+				}
+			};
 		}
 		template <class Impl>
 		template <class Weight, class Compare, class Combine>
@@ -77,6 +113,9 @@ namespace graph {
 			// TODO: Convert these to parameters
 			using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
 			auto zero = D{}, inf = std::numeric_limits<D>::max();
+			// Alone, one direction would run to completion before the other started
+			if (impl::omp_get_max_threads() < 2)
+				return this->shortest_path(s, t, weight, compare, combine);
 
 			using pair_type = std::pair<D, Vert>;
 			struct queue_compare {
@@ -88,62 +127,90 @@ namespace graph {
 			};
 			using queue_type = std::priority_queue<pair_type, std::vector<pair_type>, queue_compare>;
 
-			// Explores from one side
-			auto explore = [&](auto adjacency, Vert v, auto& near, const auto& far, auto& distance, auto& tree, const std::atomic<bool>& stop, std::exception_ptr& ex) {
-				try {
-					auto queue = queue_type(queue_compare{ compare });
-					queue.emplace(distance(v), v);
-					while (!stop.load(std::memory_order_relaxed) && !queue.empty() &&
-						!impl::_atomic_bidirectional_search_step<decltype(adjacency)>(this->_impl(),
-							queue, near, far, weight, distance, tree, compare, combine))
-						;
-				} catch (...) {
-					ex = std::current_exception();
-				}
-			};
-
-			// Construct all the structures for each exploration
-			auto s_closed = this->template ephemeral_vert_map<bool>(false),
-				t_closed = this->template ephemeral_vert_map<bool>(false);
 			auto s_distance = this->ephemeral_vert_map(inf),
 				t_distance = this->ephemeral_vert_map(inf);
 			s_distance[s] = zero;
 			t_distance[t] = zero;
 			auto s_tree = this->in_subtree(s);
 			auto t_tree = this->out_subtree(t);
-			alignas(64) std::atomic<bool> t_done{false}, s_done{false};
-			std::exception_ptr s_ex{}, t_ex{};
+			impl::_parallel_bidirectional_search_side<impl::traits::Out, Impl, queue_type, Weight, decltype(s_distance), decltype(s_tree), D>
+				s_side(this->_impl(), queue_type(queue_compare{ compare }), weight, s_distance, s_tree, zero);
+			impl::_parallel_bidirectional_search_side<impl::traits::In, Impl, queue_type, Weight, decltype(t_distance), decltype(t_tree), D>
+				t_side(this->_impl(), queue_type(queue_compare{ compare }), weight, t_distance, t_tree, zero);
+			s_side.queue.emplace(zero, s);
+			t_side.queue.emplace(zero, t);
 
-			// Explore from both sides in parallel
-			#pragma omp parallel num_threads(2)
-			{
-				#pragma omp single nowait
-				{
-					explore(impl::traits::Out{}, s, s_closed, t_closed, s_distance, s_tree, t_done, s_ex);
-					s_done.store(true);
-				}
-				#pragma omp single nowait
-				{
-					explore(impl::traits::In{}, t, t_closed, s_closed, t_distance, t_tree, s_done, t_ex);
-					t_done.store(true);
-				}
+			// Length of the shortest path found so far, and the vertex where its halves meet
+			std::atomic<D> best{ inf };
+			auto meet = this->null_vert();
+			if (s == t) {
+				best = zero;
+				meet = s;
 			}
-			// python or
-			auto ex = std::min({std::move(s_ex), std::move(s_ex)},
-				[](auto l, auto r){ return static_cast<bool>(l); });
-			if (ex)
-				std::rethrow_exception(ex);
+			// Whenever one direction labels a vertex the other has labelled, the path through it is a candidate.
+			// Distances are written and read sequentially consistently, so of two directions labelling the same vertex, at least the second sees the first.
+			auto label = [&](const auto& far_distance) {
+				return [&](const Vert& u, const D& c) {
+					const auto& far_u = far_distance(u);
+					D far;
+					#pragma omp atomic read seq_cst
+					far = far_u;
+					if (far == inf)
+						return;
+					auto total = combine(c, far);
+					if (compare(total, best.load())) {
+						#pragma omp critical(graph_parallel_shortest_path)
+						if (compare(total, best.load())) {
+							best.store(total);
+							meet = u;
+						}
+					}
+				};
+			};
+			// Vertices nearer either source than its published top have been settled, so any shorter path would have to pass beyond both frontiers.
+			// A direction which runs out has labelled everything it can reach, including wherever the halves of a shortest path meet.
+			std::atomic<bool> failed{ false };
+			auto done = [&] {
+				if (failed.load(std::memory_order_relaxed))
+					return true;
+				auto s_top = s_side.top.load(), t_top = t_side.top.load();
+				if (s_top == inf || t_top == inf)
+					return true;
+				auto mu = best.load();
+				return mu != inf && !compare(combine(s_top, t_top), mu);
+			};
+			auto explore = [&](auto& side, const auto& far_distance, std::exception_ptr& ex) {
+				try {
+					auto on_label = label(far_distance);
+					while (!done())
+						side.step(compare, combine, inf, on_label);
+				} catch (...) {
+					ex = std::current_exception();
+					failed.store(true, std::memory_order_relaxed);
+				}
+			};
 
-			// Find the minimal rendezvous
-			auto total_distance = [&](auto v) { return combine(s_distance(v), t_distance(v)); };
-			auto rendezvous = ranges::min(this->verts(), compare, total_distance);
-			if (!compare(total_distance(rendezvous), inf))
+			// Each direction is a task, and the rest of the team executes the loops of tasks they spawn for high-degree vertices
+			std::exception_ptr s_ex{}, t_ex{};
+			#pragma omp parallel
+			#pragma omp single
+			{
+				#pragma omp task
+				explore(s_side, t_distance, s_ex);
+				#pragma omp task
+				explore(t_side, s_distance, t_ex);
+			}
+			if (s_ex)
+				std::rethrow_exception(s_ex);
+			if (t_ex)
+				std::rethrow_exception(t_ex);
+			if (this->is_null(meet))
 				return this->null_path();
 
 			// Construct path from trees
 			return this->concatenate_paths(
-				s_tree.path_from_root_to(rendezvous),
-				t_tree.path_to_root_from(rendezvous));
+				s_tree.path_from_root_to(meet),
+				t_tree.path_to_root_from(meet));
 		}
 	}
 }
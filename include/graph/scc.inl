@@ -0,0 +1,300 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <utility>
+
+#include "impl/traits.hpp"
+#include "impl/omp.hpp"
+#include "impl/Csr.hpp"
+#include "impl/Atomic_bitmap.hpp"
+#include "impl/Traversal.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Tarjan's algorithm expressed as traversal events, so that it inherits the traversal's explicit stack.
+			// Components are numbered in the order they are completed, which is a reverse topological order of the condensation along `Adjacency` edges.
+			template <class Adjacency, class G>
+			struct _tarjan_visitor : Traversal_visitor {
+				using Verts = traits::Verts<G>;
+				using Vert = typename Verts::value_type;
+				using Edge = typename traits::Edges<G>::value_type;
+				static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+				explicit _tarjan_visitor(const G& g) :
+					g(g),
+					order(Verts::ephemeral_map(g, std::size_t{})),
+					low(Verts::ephemeral_map(g, std::size_t{})),
+					parent(Verts::ephemeral_map(g, Verts::null(g))),
+					component(Verts::map(g, none)) {
+				}
+
+				void discover_vert(const Vert& v) {
+					order.assign(v, ++time);
+					low.assign(v, time);
+					stack.push_back(v);
+				}
+				void tree_edge(const Edge& e) {
+					parent.assign(traits::adjacency_cokey<Adjacency, G>(g, e), traits::adjacency_key<Adjacency, G>(g, e));
+				}
+				void back_edge(const Edge& e) {
+					_lower(traits::adjacency_key<Adjacency, G>(g, e), order(traits::adjacency_cokey<Adjacency, G>(g, e)));
+				}
+				void forward_or_cross_edge(const Edge& e) {
+					// Only vertices still on the stack belong to a component which is not yet complete
+					auto u = traits::adjacency_cokey<Adjacency, G>(g, e);
+					if (component(u) == none)
+						_lower(traits::adjacency_key<Adjacency, G>(g, e), order(u));
+				}
+				void finish_vert(const Vert& v) {
+					if (low(v) == order(v)) {
+						Vert u;
+						do {
+							u = stack.back();
+							stack.pop_back();
+							component.assign(u, count);
+						} while (u != v);
+						++count;
+					}
+					auto p = parent(v);
+					if (p != Verts::null(g))
+						_lower(p, low(v));
+				}
+
+				void _lower(const Vert& v, std::size_t l) {
+					if (l < low(v))
+						low.assign(v, l);
+				}
+
+				const G& g;
+				std::size_t time = 0, count = 0;
+				typename Verts::template ephemeral_map_type<std::size_t> order, low;
+				typename Verts::template ephemeral_map_type<Vert> parent;
+				typename Verts::template map_type<std::size_t> component;
+				std::vector<Vert> stack;
+			};
+
+			template <class Adjacency, class G>
+			auto _tarjan(const G& g) {
+				using Verts = traits::Verts<G>;
+				_tarjan_visitor<Adjacency, G> visitor(g);
+				Traversal<Adjacency, G> traversal(g);
+				for (auto v : Verts::range(g))
+					traversal.depth_first_from(v, visitor);
+				return std::pair(std::move(visitor.component), visitor.count);
+			}
+
+			// Marks every vertex reachable from `s` along edges in `csr` through vertices satisfying `allowed`, calling `visit` once for each from whichever thread reached it.
+			template <class Csr, class Allowed, class Visit>
+			void _parallel_reach(const Csr& csr, typename Csr::index_type s,
+				const Allowed& allowed, Atomic_bitmap& reached, const Visit& visit) {
+				using index_type = typename Csr::index_type;
+				std::vector<index_type> frontier{ s }, next;
+				reached.insert(s);
+				visit(s);
+				while (!frontier.empty()) {
+					next.clear();
+					auto size = static_cast<std::ptrdiff_t>(frontier.size());
+					#pragma omp parallel
+					{
+						std::vector<index_type> local;
+						#pragma omp for schedule(dynamic, 64) nowait
+						for (std::ptrdiff_t i = 0; i < size; ++i) {
+							auto v = frontier[i];
+							for (auto j = csr.begin(v); j < csr.end(v); ++j) {
+								auto u = csr.cokey(j);
+								if (allowed(u) && reached.insert(u)) {
+									visit(u);
+									local.push_back(u);
+								}
+							}
+						}
+						#pragma omp critical
+						next.insert(next.end(), local.begin(), local.end());
+					}
+					std::swap(frontier, next);
+				}
+			}
+
+			// Parallel strongly connected components, combining the stages of Slota et al., "BFS and Coloring-based Parallel Algorithms for Strongly Connected Components":
+			// trivial components are trimmed, the component of a high degree pivot (usually the giant one) is found by forward-backward search, and the remainder are separated by propagating the maximum index forward and searching backward from each vertex which keeps its own.
+			template <class G>
+			auto _parallel_scc(const G& g) {
+				using Verts = traits::Verts<G>;
+				using index_type = typename Dense_index<G>::index_type;
+				constexpr auto none = Dense_index<G>::null_index;
+				Dense_index<G> index(g);
+				Csr<traits::Out, G> out(g, index);
+				Csr<traits::In, G> in(g, index);
+				auto n = static_cast<std::ptrdiff_t>(index.size());
+
+				// Each vertex is labelled with a representative of its component once it is found
+				std::vector<std::atomic<index_type>> component(index.size());
+				#pragma omp parallel for
+				for (std::ptrdiff_t i = 0; i < n; ++i)
+					component[i].store(none, std::memory_order_relaxed);
+				auto done = [&](index_type v) {
+					return component[v].load(std::memory_order_relaxed) != none;
+				};
+				auto has_remaining = [&](const auto& csr, index_type v) {
+					for (auto j = csr.begin(v); j < csr.end(v); ++j) {
+						auto u = csr.cokey(j);
+						if (u != v && !done(u))
+							return true;
+					}
+					return false;
+				};
+
+				// Trim vertices with no remaining in- or out-edges, which cannot lie on a cycle
+				for (bool changed = true; changed;) {
+					changed = false;
+					#pragma omp parallel for schedule(dynamic, 1024) reduction(||: changed)
+					for (std::ptrdiff_t i = 0; i < n; ++i) {
+						auto v = static_cast<index_type>(i);
+						if (!done(v) && (!has_remaining(out, v) || !has_remaining(in, v))) {
+							component[v].store(v, std::memory_order_relaxed);
+							changed = true;
+						}
+					}
+				}
+
+				// Forward-backward search from the remaining vertex with the most paths through it
+				auto pivot = none;
+				std::size_t best = 0;
+				for (index_type v = 0; v < index.size(); ++v) {
+					auto paths = (out.end(v) - out.begin(v)) * (in.end(v) - in.begin(v));
+					if (!done(v) && (pivot == none || paths > best)) {
+						pivot = v;
+						best = paths;
+					}
+				}
+				if (pivot != none) {
+					Atomic_bitmap forward(index.size()), backward(index.size());
+					_parallel_reach(out, pivot, [&](index_type u) { return !done(u); }, forward, [](index_type) {});
+					_parallel_reach(in, pivot, [&](index_type u) { return forward.contains(u); }, backward,
+						[&](index_type u) { component[u].store(pivot, std::memory_order_relaxed); });
+				}
+
+				// Colour the rest until every component has been found
+				std::vector<std::atomic<index_type>> colour(index.size());
+				std::vector<index_type> active, next, roots;
+				Atomic_bitmap queued(index.size());
+				for (;;) {
+					active.clear();
+					for (index_type v = 0; v < index.size(); ++v) {
+						if (!done(v)) {
+							colour[v].store(v, std::memory_order_relaxed);
+							active.push_back(v);
+						}
+					}
+					if (active.empty())
+						break;
+					roots = active;
+					// Propagate the largest index along out-edges, revisiting only vertices whose colour changed
+					while (!active.empty()) {
+						next.clear();
+						auto size = static_cast<std::ptrdiff_t>(active.size());
+						#pragma omp parallel
+						{
+							std::vector<index_type> local;
+							// Any raise of a colour read below must queue it again, and the barrier orders these before every such raise
+							#pragma omp for schedule(static)
+							for (std::ptrdiff_t i = 0; i < size; ++i)
+								queued.erase(active[i]);
+							#pragma omp for schedule(dynamic, 256) nowait
+							for (std::ptrdiff_t i = 0; i < size; ++i) {
+								auto v = active[i];
+								auto c = colour[v].load(std::memory_order_relaxed);
+								for (auto j = out.begin(v); j < out.end(v); ++j) {
+									auto u = out.cokey(j);
+									if (done(u))
+										continue;
+									auto cu = colour[u].load(std::memory_order_relaxed);
+									bool raised = false;
+									while (cu < c && !(raised = colour[u].compare_exchange_weak(cu, c, std::memory_order_relaxed)))
+										;
+									if (raised && queued.insert(u))
+										local.push_back(u);
+								}
+							}
+							#pragma omp critical
+							next.insert(next.end(), local.begin(), local.end());
+						}
+						std::swap(active, next);
+					}
+					// The component of each vertex which kept its own colour is what reaches it backward within that colour, and colours are disjoint so these searches are independent
+					roots.erase(std::remove_if(roots.begin(), roots.end(),
+						[&](index_type v) { return colour[v].load(std::memory_order_relaxed) != v; }), roots.end());
+					auto root_count = static_cast<std::ptrdiff_t>(roots.size());
+					#pragma omp parallel
+					{
+						std::vector<index_type> queue;
+						#pragma omp for schedule(dynamic, 1)
+						for (std::ptrdiff_t i = 0; i < root_count; ++i) {
+							auto r = roots[i];
+							component[r].store(r, std::memory_order_relaxed);
+							queue.assign(1, r);
+							for (std::size_t head = 0; head < queue.size(); ++head) {
+								auto v = queue[head];
+								for (auto j = in.begin(v); j < in.end(v); ++j) {
+									auto u = in.cokey(j);
+									if (!done(u) && colour[u].load(std::memory_order_relaxed) == r) {
+										component[u].store(r, std::memory_order_relaxed);
+										queue.push_back(u);
+									}
+								}
+							}
+						}
+					}
+				}
+
+				// Number components consecutively
+				std::vector<std::size_t> id(index.size(), std::numeric_limits<std::size_t>::max());
+				std::size_t count = 0;
+				auto result = Verts::map(g, std::size_t{});
+				for (index_type v = 0; v < index.size(); ++v) {
+					auto& c = id[component[v].load(std::memory_order_relaxed)];
+					if (c == std::numeric_limits<std::size_t>::max())
+						c = count++;
+					result.assign(index[v], c);
+				}
+				return std::pair(std::move(result), count);
+			}
+		}
+		template <class Impl>
+		auto Out_edge_graph<Impl>::scc() const {
+			return impl::_tarjan<impl::traits::Out>(this->_impl());
+		}
+		template <class Impl>
+		auto In_edge_graph<Impl>::scc() const {
+			return impl::_tarjan<impl::traits::In>(this->_impl());
+		}
+		template <class Impl>
+		auto Bi_edge_graph<Impl>::scc() const {
+			return impl::_parallel_scc(this->_impl());
+		}
+		template <class Impl>
+		template <class Components, class Dag>
+		auto Graph<Impl>::condensation(const Components& components, std::size_t count, Dag& dag) const {
+			std::vector<typename Dag::Vert> verts;
+			verts.reserve(count);
+			for (std::size_t i = 0; i < count; ++i)
+				verts.push_back(dag.insert_vert());
+			std::vector<std::pair<std::size_t, std::size_t>> arcs;
+			for (auto e : edges()) {
+				auto s = components(tail(e)), t = components(head(e));
+				if (s != t)
+					arcs.emplace_back(s, t);
+			}
+			std::sort(arcs.begin(), arcs.end());
+			arcs.erase(std::unique(arcs.begin(), arcs.end()), arcs.end());
+			for (auto [s, t] : arcs)
+				dag.insert_edge(verts[s], verts[t]);
+			return verts;
+		}
+	}
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
+#include "impl/traits.hpp"
+#include "impl/exceptions.hpp"
+#include "impl/omp.hpp"
+#include "impl/Csr.hpp"
+#include "impl/Dijkstra_workspace.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Reusable workspace for bidirectional Dijkstra searches over a dense snapshot of a graph, with edge weights laid out alongside each adjacency
+			template <class G, class D>
+			class _bidirectional_dijkstra {
+				using index_type = typename Dense_index<G>::index_type;
+				using Edge = typename traits::Edges<G>::value_type;
+				using _side = Dijkstra_workspace<index_type, D>;
+
+			public:
+				_bidirectional_dijkstra(const Csr<traits::Out, G>& out, const std::vector<D>& out_weight,
+					const Csr<traits::In, G>& in, const std::vector<D>& in_weight, std::size_t n) :
+					_out(out), _in(in), _out_weight(out_weight), _in_weight(in_weight), _forward(n), _backward(n) {
+				}
+
+				// Finds a shortest path from `s` to `t`, appending its edges to `path` in order, and returns whether there is one
+				template <class Compare, class Combine>
+				bool search(index_type s, index_type t, std::vector<Edge>& path,
+					const Compare& compare, const Combine& combine, D zero, D inf) {
+					auto best = inf;
+					auto meet = Dense_index<G>::null_index;
+					_forward.start(s, zero);
+					_backward.start(t, zero);
+					if (s == t) {
+						best = zero;
+						meet = s;
+					}
+					// Settles the nearest vertex on one side, keeping the best path through any vertex the other side has labelled
+					auto step = [&](_side& near, const _side& far, const auto& csr, const std::vector<D>& weight) {
+						auto [d, v] = near.pop(compare);
+						if (compare(near.distance(v, inf), d))
+							return; // stale entry
+						for (auto k = csr.begin(v); k < csr.end(v); ++k) {
+							auto u = csr.cokey(k);
+							auto c = combine(d, weight[k]);
+							if (compare(c, near.distance(u, inf))) {
+								near.relax(u, c, v, k, compare);
+								auto du = far.distance(u, inf);
+								if (du != inf && compare(combine(c, du), best)) {
+									best = combine(c, du);
+									meet = u;
+								}
+							}
+						}
+					};
+					// Stop once the frontiers together are no nearer than the best path, as in `Bi_edge_graph::shortest_path`
+					while (!_forward.empty() && !_backward.empty() &&
+						(best == inf || compare(combine(_forward.top(), _backward.top()), best))) {
+						if (_backward.size() < _forward.size())
+							step(_backward, _forward, _in, _in_weight);
+						else
+							step(_forward, _backward, _out, _out_weight);
+					}
+					if (meet == Dense_index<G>::null_index)
+						return false;
+
+					// Walk back to `s` and forward to `t` from where the searches met
+					auto first = path.size();
+					for (auto v = meet; v != s; v = _forward.parent(v).first)
+						path.push_back(_out.edge(_forward.parent(v).second));
+					std::reverse(path.begin() + first, path.end());
+					for (auto v = meet; v != t; v = _backward.parent(v).first)
+						path.push_back(_in.edge(_backward.parent(v).second));
+					return true;
+				}
+
+			private:
+				const Csr<traits::Out, G>& _out;
+				const Csr<traits::In, G>& _in;
+				const std::vector<D>& _out_weight;
+				const std::vector<D>& _in_weight;
+				_side _forward, _backward;
+			};
+		}
+		template <class Impl>
+		template <class Queries, class Weight, class Output, class Compare, class Combine>
+		void Bi_edge_graph<Impl>::shortest_paths_batch(const Queries& queries, const Weight& weight, Output paths,
+			const Compare& compare, const Combine& combine) const {
+			// TODO: Convert these to parameters
+			using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
+			auto zero = D{}, inf = std::numeric_limits<D>::max();
+
+			const auto& g = this->_impl();
+			impl::Dense_index<Impl> index(g);
+			impl::Csr<impl::traits::Out, Impl> out(g, index);
+			impl::Csr<impl::traits::In, Impl> in(g, index);
+			auto out_weight = impl::nonnegative_weights(out, weight, compare, combine, zero);
+			auto in_weight = impl::nonnegative_weights(in, weight, compare, combine, zero);
+
+			auto count = static_cast<std::ptrdiff_t>(std::size(queries));
+			// Exceptions cannot escape the parallel region, so the first is rethrown after it
+			std::exception_ptr ex;
+			#pragma omp parallel
+			{
+				// Each thread reuses its workspace for every query it takes
+				impl::_bidirectional_dijkstra<Impl, D> search(out, out_weight, in, in_weight, index.size());
+				std::vector<Edge> edges;
+				// Queries vary wildly in cost, so they are handed out a few at a time to whichever thread is free
+				#pragma omp for schedule(dynamic, 4)
+				for (std::ptrdiff_t i = 0; i < count; ++i) {
+					try {
+						const auto& [s, t] = queries[i];
+						edges.clear();
+						if (search.search(index(s), index(t), edges, compare, combine, zero, inf))
+							paths[i] = this->path(s, edges);
+						else
+							paths[i] = this->null_path();
+					} catch (...) {
+						#pragma omp critical(graph_shortest_paths_batch_exception)
+						if (!ex)
+							ex = std::current_exception();
+					}
+				}
+			}
+			if (ex)
+				std::rethrow_exception(ex);
+		}
+	}
+}
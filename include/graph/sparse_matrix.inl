@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include "impl/omp.hpp"
+#include "impl/exceptions.hpp"
+#include "impl/Sparse_matrix.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		template <class Impl>
+		template <class Weight>
+		auto Graph<Impl>::adjacency_matrix(const Weight& weight) const {
+			using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
+			return impl::Sparse_matrix<Impl, D>(this->_impl(), weight);
+		}
+
+		// Multiplies a matrix by a dense column vector, `y[i] = add(multiply(a[i][j], x[j]) for each j)`, for each row `i` selected by `mask` and leaving the others zero.
+		// Each row is gathered by one thread, so no synchronization is needed.
+		template <class G, class T, class Semiring, class Mask = No_mask>
+		std::vector<T> mxv(const impl::Sparse_matrix<G, T>& a, const std::vector<T>& x,
+			const Semiring& semiring, const Mask& mask = {}) {
+			auto n = static_cast<std::ptrdiff_t>(a.order());
+			impl::check_precondition(x.size() == a.order(), "vector must have an entry for each column");
+			std::vector<T> y(a.order(), semiring.zero());
+			#pragma omp parallel for schedule(dynamic, 1024)
+			for (std::ptrdiff_t i = 0; i < n; ++i) {
+				auto r = static_cast<typename impl::Sparse_matrix<G, T>::index_type>(i);
+				if (mask(r))
+					y[i] = impl::_dot(semiring, a.values(), a.columns(), a.begin(r), a.end(r), x.data());
+			}
+			return y;
+		}
+		// Multiplies a matrix by a sparse column vector, whose entries are first spread into a dense one
+		template <class G, class T, class Semiring, class Mask = No_mask>
+		std::vector<T> mxv(const impl::Sparse_matrix<G, T>& a, const Sparse_vector<T>& x,
+			const Semiring& semiring, const Mask& mask = {}) {
+			std::vector<T> dense(a.order(), semiring.zero());
+			for (std::size_t k = 0; k < x.size(); ++k)
+				dense[x.indices[k]] = x.values[k];
+			return mxv(a, dense, semiring, mask);
+		}
+
+		// Multiplies a sparse row vector by a matrix, `y[j] = add(multiply(x[i], a[i][j]) for each i)`, for each column `j` selected by `mask`.
+		// Only the rows of the entries of `x` are read, so this costs time proportional to their entries rather than to the whole matrix.  Threads collect products separately, and products for the same column are then summed in order of their rows.
+		template <class G, class T, class Semiring, class Mask = No_mask>
+		Sparse_vector<T> vxm(const Sparse_vector<T>& x, const impl::Sparse_matrix<G, T>& a,
+			const Semiring& semiring, const Mask& mask = {}) {
+			using index_type = typename impl::Sparse_matrix<G, T>::index_type;
+			struct product {
+				index_type column, row;
+				T value;
+			};
+			std::vector<product> products;
+			auto size = static_cast<std::ptrdiff_t>(x.size());
+			#pragma omp parallel
+			{
+				std::vector<product> local;
+				#pragma omp for schedule(dynamic, 64) nowait
+				for (std::ptrdiff_t k = 0; k < size; ++k) {
+					auto i = x.indices[k];
+					for (auto l = a.begin(i); l < a.end(i); ++l) {
+						auto j = a.columns()[l];
+						if (mask(j))
+							local.push_back(product{ j, i, semiring.multiply(x.values[k], a.values()[l]) });
+					}
+				}
+				#pragma omp critical
+				products.insert(products.end(), local.begin(), local.end());
+			}
+			std::sort(products.begin(), products.end(), [](const product& l, const product& r) {
+				return l.column < r.column || (l.column == r.column && l.row < r.row);
+			});
+			Sparse_vector<T> y;
+			for (std::size_t k = 0; k < products.size();) {
+				auto j = products[k].column;
+				T sum = products[k].value;
+				for (++k; k < products.size() && products[k].column == j; ++k)
+					sum = semiring.add(sum, products[k].value);
+				// Products may cancel, but only entries which are not zero are stored
+				if (sum != semiring.zero())
+					y.push_back(j, sum);
+			}
+			return y;
+		}
+		// Multiplies a dense row vector by a matrix, reading only the rows where it is not zero.  For vectors with few zeros, `mxv` with the transpose avoids collecting products.
+		template <class G, class T, class Semiring, class Mask = No_mask>
+		Sparse_vector<T> vxm(const std::vector<T>& x, const impl::Sparse_matrix<G, T>& a,
+			const Semiring& semiring, const Mask& mask = {}) {
+			impl::check_precondition(x.size() == a.order(), "vector must have an entry for each row");
+			Sparse_vector<T> sparse;
+			for (std::size_t i = 0; i < x.size(); ++i)
+				if (x[i] != semiring.zero())
+					sparse.push_back(static_cast<typename Sparse_vector<T>::index_type>(i), x[i]);
+			return vxm(sparse, a, semiring, mask);
+		}
+	}
+}
@@ -1,8 +1,7 @@
 #pragma once
 
 #include "impl/Subforest.hpp"
-
-#include <queue>
+#include "impl/Indexed_heap.hpp"
 
 namespace graph {
 	inline namespace v1 {
@@ -19,6 +18,7 @@ namespace graph {
 			return _wrap_graph(Subtree_impl(this->_impl(), std::move(root)));
 		}
 		namespace impl {
+			// Eager Prim's algorithm: the heap holds each vertex adjacent to the tree at most once, keyed by the lightest edge reaching it so far, so it never grows beyond the order of the graph.
 			template <class Adjacency, class G, class WM, class Compare>
 			auto _prim(const G& g, const Vert<G>& v, const WM& weight, const Compare& compare) {
 				using Verts = traits::Verts<G>;
@@ -27,29 +27,25 @@ namespace graph {
 				auto tree = Subtree<traits::Reverse_adjacency<Adjacency>, G>(g, v);
 				auto closed = Verts::ephemeral_set(g);
 				using weight_type = std::decay_t<std::result_of_t<const WM&(typename Edges::value_type)>>;
-				using pair_type = std::pair<weight_type, Edge<G>>;
-				struct queue_compare {
-					const Compare& compare;
-					bool operator()(const pair_type& l, const pair_type& r) const {
-						// arguments reversed because std::priority_queue is a max queue
-						return compare(r.first, l.first);
+				using Positions = typename Verts::template ephemeral_map_type<std::size_t>;
+				using Heap = Indexed_heap<Vert<G>, weight_type, Positions, Compare>;
+				Heap heap(Verts::ephemeral_map(g, Heap::npos), compare);
+				// Lightest edge from the tree to each vertex in the heap
+				auto lightest = Verts::ephemeral_map(g, Edges::null(g));
+				auto relax_edges = [&](const Vert<G>& u) {
+					for (auto e : Adjacencies::range(g, u)) {
+						auto w = traits::adjacency_cokey<Adjacency>(g, e);
+						if (!closed.contains(w) && heap.push_or_decrease(w, weight(e)))
+							lightest.assign(w, e);
 					}
 				};
-				std::priority_queue<pair_type, std::vector<pair_type>, queue_compare> queue(queue_compare{compare});
-				auto enqueue_edges = [&](typename Verts::value_type u){
-					for (auto e : Adjacencies::range(g, u))
-						queue.emplace(weight(e), std::move(e));
-				};
 				closed.insert(v);
-				enqueue_edges(v);
-				while (!queue.empty()) {
-					auto [_, e] = queue.top();
-					queue.pop();
-					auto v = traits::adjacency_cokey<Adjacency>(g, e);
-					if (closed.insert(v)) {
-						tree.insert_edge(e);
-						enqueue_edges(v);
-					}
+				relax_edges(v);
+				while (!heap.empty()) {
+					auto u = heap.pop().first;
+					closed.insert(u);
+					tree.insert_edge(lightest(u));
+					relax_edges(u);
 				}
 				return tree;
 			}
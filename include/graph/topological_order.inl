@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <utility>
+
+#include "impl/traits.hpp"
+#include "impl/exceptions.hpp"
+#include "impl/omp.hpp"
+#include "impl/Csr.hpp"
+#include "impl/Subforest.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Kahn's algorithm: repeatedly removes a vertex with no remaining in-edges.  Vertices left over lie on or after a cycle.
+			template <class G>
+			auto _topological_order(const G& g) {
+				using Verts = traits::Verts<G>;
+				using Edges = traits::Edges<G>;
+				using Out_edges = traits::Out_edges<G>;
+				using Vert = typename Verts::value_type;
+				auto remaining = Verts::ephemeral_map(g, std::size_t{});
+				if constexpr (traits::has_in_edges<G>) {
+					for (auto v : Verts::range(g))
+						remaining.assign(v, static_cast<std::size_t>(traits::In_edges<G>::size(g, v)));
+				} else {
+					for (auto e : Edges::range(g)) {
+						auto v = Edges::head(g, e);
+						remaining.assign(v, remaining(v) + 1);
+					}
+				}
+				std::vector<Vert> order;
+				order.reserve(static_cast<std::size_t>(Verts::size(g)));
+				for (auto v : Verts::range(g))
+					if (remaining(v) == 0)
+						order.push_back(v);
+				// The order itself serves as the queue
+				for (std::size_t head = 0; head < order.size(); ++head) {
+					for (auto e : Out_edges::range(g, order[head])) {
+						auto u = Edges::head(g, e);
+						auto r = remaining(u) - 1;
+						remaining.assign(u, r);
+						if (r == 0)
+							order.push_back(u);
+					}
+				}
+				if (order.size() != static_cast<std::size_t>(Verts::size(g)))
+					throw precondition_unmet("graph must be acyclic");
+				return order;
+			}
+
+			// Kahn's algorithm removing a whole level of vertices at a time, with each thread decrementing the in-degrees of the heads of its vertices' out-edges.  The graph is only read, so its adjacencies are traversed directly.
+			template <class G>
+			auto _parallel_topological_order(const G& g) {
+				using Edges = traits::Edges<G>;
+				using Out_edges = traits::Out_edges<G>;
+				using In_edges = traits::In_edges<G>;
+				using index_type = typename Dense_index<G>::index_type;
+				Dense_index<G> index(g);
+				auto n = static_cast<std::ptrdiff_t>(index.size());
+				std::vector<std::atomic<index_type>> remaining(index.size());
+				#pragma omp parallel for schedule(static, 4096)
+				for (std::ptrdiff_t i = 0; i < n; ++i)
+					remaining[i].store(static_cast<index_type>(In_edges::size(g, index[static_cast<index_type>(i)])), std::memory_order_relaxed);
+				std::vector<index_type> frontier, next;
+				for (index_type v = 0; v < index.size(); ++v)
+					if (remaining[v].load(std::memory_order_relaxed) == 0)
+						frontier.push_back(v);
+				std::vector<typename traits::Verts<G>::value_type> order;
+				order.reserve(index.size());
+				while (!frontier.empty()) {
+					for (auto v : frontier)
+						order.push_back(index[v]);
+					next.clear();
+					auto size = static_cast<std::ptrdiff_t>(frontier.size());
+					#pragma omp parallel
+					{
+						std::vector<index_type> local;
+						#pragma omp for schedule(dynamic, 64) nowait
+						for (std::ptrdiff_t i = 0; i < size; ++i) {
+							for (auto e : Out_edges::range(g, index[frontier[i]])) {
+								auto u = index(Edges::head(g, e));
+								// Exactly one thread removes the last in-edge
+								if (remaining[u].fetch_sub(1, std::memory_order_relaxed) == 1)
+									local.push_back(u);
+							}
+						}
+						#pragma omp critical
+						next.insert(next.end(), local.begin(), local.end());
+					}
+					std::swap(frontier, next);
+				}
+				if (order.size() != index.size())
+					throw precondition_unmet("graph must be acyclic");
+				return order;
+			}
+
+			// Relaxes the out-edges of each vertex in topological order, so every distance is final before it is used and weights may be negative.
+			template <class G, class Order, class Weight, class Compare, class Combine, class D>
+			std::pair<
+				Subtree<traits::In, G>,
+				Vert_map<G, D>>
+			_dag_paths(const G& g, const Order& order, Vert<G> s, const Weight& weight,
+				const Compare& compare, const Combine& combine,
+				D zero, D inf) {
+				using Verts = traits::Verts<G>;
+				using Edges = traits::Edges<G>;
+				auto tree = Subtree<traits::In, G>(g, s);
+				auto distance = Verts::map(g, inf);
+				// Reachability is tracked apart from distances, since `inf` may equal `zero`, as the lowest unsigned value does
+				auto reached = Verts::ephemeral_map(g, std::uint8_t{});
+				distance.assign(s, zero);
+				reached.assign(s, 1);
+				// Vertices before the source cannot be reached from it
+				auto first = std::find(order.begin(), order.end(), s);
+				for (auto it = first; it != order.end(); ++it) {
+					if (!reached(*it))
+						continue;
+					auto d = distance(*it);
+					for (auto e : traits::Out_edges<G>::range(g, *it)) {
+						auto u = Edges::head(g, e);
+						auto c = combine(d, weight(e));
+						if (!reached(u) || compare(c, distance(u))) {
+							reached.assign(u, 1);
+							distance.assign(u, c);
+							tree.insert_edge(e); // replace the old edge in the tree
+						}
+					}
+				}
+				return std::pair(std::move(tree), std::move(distance));
+			}
+		}
+		template <class Impl>
+		auto Out_edge_graph<Impl>::topological_order() const {
+			return impl::_topological_order(this->_impl());
+		}
+		template <class Impl>
+		auto Bi_edge_graph<Impl>::parallel_topological_order() const {
+			return impl::_parallel_topological_order(this->_impl());
+		}
+		template <class Impl>
+		template <class Weight, class Compare, class Combine>
+		auto Out_edge_graph<Impl>::dag_shortest_paths_from(const Vert& s, const Weight& weight,
+			const Compare& compare, const Combine& combine) const {
+			// TODO: Convert these to parameters
+			using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
+			auto zero = D{}, inf = std::numeric_limits<D>::max();
+
+			const auto& g = this->_impl();
+			auto [tree, distance] = impl::_dag_paths(g, impl::_topological_order(g), s, weight, compare, combine, zero, inf);
+			return std::make_pair(_wrap_graph(std::move(tree)), std::move(distance));
+		}
+		template <class Impl>
+		template <class Weight, class Compare, class Combine>
+		auto Out_edge_graph<Impl>::dag_longest_paths_from(const Vert& s, const Weight& weight,
+			const Compare& compare, const Combine& combine) const {
+			// TODO: Convert these to parameters
+			using D = std::decay_t<std::result_of_t<const Weight&(Edge)>>;
+			auto zero = D{}, inf = std::numeric_limits<D>::lowest();
+
+			const auto& g = this->_impl();
+			auto reversed = [&](const D& l, const D& r) { return compare(r, l); };
+			auto [tree, distance] = impl::_dag_paths(g, impl::_topological_order(g), s, weight, reversed, combine, zero, inf);
+			return std::make_pair(_wrap_graph(std::move(tree)), std::move(distance));
+		}
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "impl/Traversal.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		template <class Impl>
+		auto Out_edge_graph<Impl>::out_traversal() const {
+			return impl::Traversal<impl::traits::Out, Impl>(this->_impl());
+		}
+		template <class Impl>
+		auto In_edge_graph<Impl>::in_traversal() const {
+			return impl::Traversal<impl::traits::In, Impl>(this->_impl());
+		}
+	}
+}
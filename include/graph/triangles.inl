@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#include "impl/traits.hpp"
+#include "impl/omp.hpp"
+#include "impl/Csr.hpp"
+
+namespace graph {
+	inline namespace v1 {
+		namespace impl {
+			// Simple undirected graph underlying a graph, with each edge oriented from the endpoint of lower degree to that of higher degree, so that no vertex has more than about the square root of the number of edges as out-neighbors.
+			// Vertices are renumbered by their rank in that order, and out-neighbors are sorted, so that they can be intersected by merging.
+			template <class G>
+			struct _oriented_graph {
+				using index_type = typename Dense_index<G>::index_type;
+
+				explicit _oriented_graph(const G& g) : index(g) {
+					using Edges = traits::Edges<G>;
+					auto n = index.size();
+					// Undirected edges without loops or duplicates
+					std::vector<std::pair<index_type, index_type>> edges;
+					edges.reserve(static_cast<std::size_t>(Edges::size(g)));
+					for (auto e : Edges::range(g)) {
+						auto u = index(Edges::tail(g, e)), v = index(Edges::head(g, e));
+						if (u != v)
+							edges.emplace_back(std::min(u, v), std::max(u, v));
+					}
+					std::sort(edges.begin(), edges.end());
+					edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+					degree.assign(n, 0);
+					for (auto [u, v] : edges) {
+						++degree[u];
+						++degree[v];
+					}
+					std::vector<index_type> order(n);
+					for (index_type v = 0; v < n; ++v)
+						order[v] = v;
+					std::sort(order.begin(), order.end(), [&](index_type u, index_type v) {
+						return degree[u] < degree[v] || (degree[u] == degree[v] && u < v);
+					});
+					rank.resize(n);
+					for (index_type i = 0; i < n; ++i)
+						rank[order[i]] = i;
+					offsets.assign(n + 1, 0);
+					for (auto& [u, v] : edges) {
+						u = rank[u];
+						v = rank[v];
+						if (v < u)
+							std::swap(u, v);
+						++offsets[u + 1];
+					}
+					for (std::size_t i = 0; i < n; ++i)
+						offsets[i + 1] += offsets[i];
+					neighbors.resize(edges.size());
+					auto next = offsets;
+					// Edges are visited in order of their heads within each tail, so the out-neighbors come out sorted
+					std::sort(edges.begin(), edges.end(), [](const auto& l, const auto& r) { return l.second < r.second; });
+					for (auto [u, v] : edges)
+						neighbors[next[u]++] = v;
+				}
+
+				const index_type* begin(index_type u) const {
+					return neighbors.data() + offsets[u];
+				}
+				const index_type* end(index_type u) const {
+					return neighbors.data() + offsets[u + 1];
+				}
+
+				Dense_index<G> index;
+				// Undirected degree by dense index, and rank by dense index
+				std::vector<std::size_t> degree;
+				std::vector<index_type> rank;
+				std::vector<std::size_t> offsets;
+				std::vector<index_type> neighbors;
+			};
+
+			// Calls `visit` with each element common to two sorted ranges.
+			// Ranges of similar length are merged without branching on the comparison; a much shorter one is instead searched for in the longer by galloping.
+			template <class T, class Visit>
+			void _intersect(const T* a, const T* a_end, const T* b, const T* b_end, const Visit& visit) {
+				if (a_end - a > b_end - b) {
+					std::swap(a, b);
+					std::swap(a_end, b_end);
+				}
+				if ((a_end - a) * 32 < b_end - b) {
+					for (; a != a_end && b != b_end; ++a) {
+						// Double the step until it passes the element, then search back within the last step
+						std::ptrdiff_t step = 1;
+						while (step < b_end - b && b[step] < *a)
+							step *= 2;
+						b = std::lower_bound(b + step / 2, b + std::min(step + 1, b_end - b), *a);
+						if (b != b_end && *b == *a)
+							visit(*a);
+					}
+					return;
+				}
+				while (a != a_end && b != b_end) {
+					auto x = *a, y = *b;
+					if (x == y)
+						visit(x);
+					a += x <= y;
+					b += y <= x;
+				}
+			}
+
+			// Counts triangles by intersecting the out-neighbors of the ends of each oriented edge, so each triangle is found exactly once, from its vertex of lowest rank, and calls `visit(u, v, w)` with its vertices by rank.
+			template <class G, class Visit>
+			std::size_t _triangles(const _oriented_graph<G>& h, const Visit& visit) {
+				using index_type = typename _oriented_graph<G>::index_type;
+				auto n = static_cast<std::ptrdiff_t>(h.index.size());
+				std::size_t count = 0;
+				#pragma omp parallel for schedule(dynamic, 64) reduction(+: count)
+				for (std::ptrdiff_t i = 0; i < n; ++i) {
+					auto u = static_cast<index_type>(i);
+					for (auto p = h.begin(u); p != h.end(u); ++p) {
+						auto v = *p;
+						_intersect(h.begin(u), h.end(u), h.begin(v), h.end(v), [&](index_type w) {
+							visit(u, v, w);
+							++count;
+						});
+					}
+				}
+				return count;
+			}
+		}
+		template <class Impl>
+		std::size_t Graph<Impl>::count_triangles() const {
+			impl::_oriented_graph<Impl> h(this->_impl());
+			return impl::_triangles(h, [](auto, auto, auto) {});
+		}
+		template <class Impl>
+		auto Graph<Impl>::clustering_coefficients() const {
+			using index_type = typename impl::Dense_index<Impl>::index_type;
+			impl::_oriented_graph<Impl> h(this->_impl());
+			auto n = h.index.size();
+			std::vector<std::size_t> triangles(n);
+			impl::_triangles(h, [&](index_type u, index_type v, index_type w) {
+				for (auto x : { u, v, w }) {
+					#pragma omp atomic
+					++triangles[x];
+				}
+			});
+			auto coefficients = vert_map(0.0);
+			// Triangles were counted by rank
+			std::vector<index_type> order(n);
+			for (index_type v = 0; v < n; ++v)
+				order[h.rank[v]] = v;
+			for (index_type i = 0; i < n; ++i) {
+				auto v = order[i];
+				auto d = h.degree[v];
+				if (d >= 2)
+					coefficients.assign(h.index[v], 2.0 * triangles[i] / (d * (d - 1)));
+			}
+			return coefficients;
+		}
+	}
+}
@@ -117,6 +117,35 @@ SCENARIO("out-adjacency lists behave properly", "[Out_adjacency_list]") {
 				REQUIRE((!tree.in_tree(g.tail(e)) || tree.in_tree(g.head(e))));
 			// TODO: Use the cut lemma to verify this tree has minimal weight
 		}
+		WHEN("searching for the minimum spanning tree with random weights") {
+			auto s = gt.random_vert(r);
+			auto weight = g.edge_map(0);
+			for (auto e : g.edges())
+				weight[e] = std::uniform_int_distribution(0, 100)(r);
+			auto tree = g.minimum_tree_reachable_from(s, weight);
+			// Compare against growing the tree by the lightest edge leaving it, found by scanning every edge
+			auto reached = g.vert_map(0);
+			reached[s] = 1;
+			int expected = 0;
+			for (;;) {
+				auto lightest = g.null_edge();
+				for (auto e : g.edges())
+					if (reached(g.tail(e)) && !reached(g.head(e)) && (lightest == g.null_edge() || weight(e) < weight(lightest)))
+						lightest = e;
+				if (lightest == g.null_edge())
+					break;
+				reached[g.head(lightest)] = 1;
+				expected += weight(lightest);
+			}
+			int total = 0;
+			for (auto v : g.verts()) {
+				REQUIRE(tree.in_tree(v) == bool(reached(v)));
+				auto e = tree.in_edge_or_null(v);
+				if (e != g.null_edge())
+					total += weight(e);
+			}
+			REQUIRE(total == expected);
+		}
 	}
 }
 
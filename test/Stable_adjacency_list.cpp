@@ -4,6 +4,13 @@
 #include "Graph_tester.hpp"
 
 #include <numeric> // for std::accumulate
+#include <sstream>
+#include <set>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <atomic>
 
 SCENARIO("stable out-adjacency lists behave properly", "[Stable_out_adjacency_list]") {
 	using G = graph::Stable_out_adjacency_list;
@@ -75,13 +82,236 @@ SCENARIO("stable out-adjacency lists behave properly", "[Stable_out_adjacency_li
 			for (auto e : g.edges())
 				REQUIRE(!(distances(g.head(e)) > distances(g.tail(e)) + weight(e)));
 		}
+		WHEN("finding strongly connected components") {
+			auto [components, count] = g.scc();
+			auto reaches = [&](auto s, auto t) {
+				auto [_, hops] = g.breadth_first_search_from(s);
+				return hops(t) != std::numeric_limits<std::size_t>::max();
+			};
+			// Verify vertices share a component exactly when they reach each other
+			std::set<std::size_t> distinct;
+			for (auto s : g.verts()) {
+				distinct.insert(components(s));
+				for (auto t : g.verts())
+					REQUIRE((components(s) == components(t)) == (reaches(s, t) && reaches(t, s)));
+			}
+			REQUIRE(distinct.size() == count);
+			// Verify components are numbered in reverse topological order and condense to a DAG
+			graph::Stable_out_adjacency_list dag;
+			auto verts = g.condensation(components, count, dag);
+			REQUIRE(dag.order() == count);
+			REQUIRE(dag.scc().second == count);
+			for (auto e : g.edges()) {
+				auto s = components(g.tail(e)), t = components(g.head(e));
+				REQUIRE(s >= t);
+				if (s != t) {
+					auto out_edges = dag.out_edges(verts[s]);
+					REQUIRE(std::any_of(out_edges.begin(), out_edges.end(), [&](auto f) { return dag.head(f) == verts[t]; }));
+				}
+			}
+		}
+		WHEN("searching breadth-first from a vertex") {
+			auto s = gt.random_vert(r);
+			auto [tree, hops] = g.breadth_first_search_from(s);
+			auto [_, distances] = g.shortest_paths_from(s, [](auto e) { return std::size_t{1}; });
+			REQUIRE(tree.root() == s);
+			for (auto v : g.verts()) {
+				REQUIRE(hops(v) == distances(v));
+				auto e = tree.in_edge_or_null(v);
+				if (e != g.null_edge()) {
+					REQUIRE(g.head(e) == v);
+					REQUIRE(hops(v) == hops(g.tail(e)) + 1);
+				} else {
+					REQUIRE((v == s || !tree.in_tree(v)));
+				}
+			}
+		}
+		WHEN("ranking vertices by PageRank") {
+			// An extra vertex without out-edges
+			gt.insert_vert();
+			auto ranks = g.pagerank(0.85, 1e-12);
+			// Verify the ranks sum to one and are a fixed point of the iteration
+			const double damping = 0.85;
+			auto expected = g.vert_map(0.0);
+			double total = 0, dangling = 0;
+			for (auto v : g.verts()) {
+				total += ranks(v);
+				if (g.out_degree(v) == 0)
+					dangling += ranks(v);
+			}
+			REQUIRE(std::abs(total - 1) < 1e-9);
+			for (auto e : g.edges())
+				expected[g.head(e)] += damping * ranks(g.tail(e)) / g.out_degree(g.tail(e));
+			for (auto v : g.verts())
+				REQUIRE(std::abs(ranks(v) - (expected(v) + (1 - damping + damping * dangling) / g.order())) < 1e-9);
+		}
+		WHEN("finding betweenness centrality") {
+			// Count shortest paths with multiplicity, and their lengths, from every vertex
+			auto paths = g.vert_map(g.vert_map(0.0));
+			auto hops = g.vert_map(g.vert_map(std::size_t{}));
+			for (auto s : g.verts()) {
+				auto [_, h] = g.breadth_first_search_from(s);
+				std::vector<G::Vert> order(g.verts().begin(), g.verts().end());
+				std::sort(order.begin(), order.end(), [&](auto u, auto v) { return h(u) < h(v); });
+				auto count = g.vert_map(0.0);
+				count[s] = 1;
+				for (auto v : order)
+					for (auto e : g.out_edges(v))
+						if (h(v) != std::numeric_limits<std::size_t>::max() && h(g.head(e)) == h(v) + 1)
+							count[g.head(e)] += count(v);
+				for (auto v : g.verts()) {
+					paths[s][v] = count(v);
+					hops[s][v] = h(v);
+				}
+			}
+			auto expected = g.vert_map(0.0);
+			for (auto v : g.verts())
+				for (auto s : g.verts())
+					for (auto t : g.verts())
+						if (s != v && t != v && s != t && paths(s)(t) > 0 && hops(s)(v) + hops(v)(t) == hops(s)(t))
+							expected[v] += paths(s)(v) * paths(v)(t) / paths(s)(t);
+			auto centrality = g.betweenness_centrality();
+			auto weighted = g.betweenness_centrality([](auto e) { return 1.0; });
+			for (auto v : g.verts()) {
+				REQUIRE(centrality(v) == Approx(expected(v)).margin(1e-9));
+				REQUIRE(weighted(v) == Approx(expected(v)).margin(1e-9));
+			}
+			// Sampling is exact once there would be as many samples as vertices
+			auto exact = g.approximate_betweenness_centrality(0.01, 0.1, r);
+			const double epsilon = 0.5;
+			auto approximate = g.approximate_betweenness_centrality(epsilon, 0.1, r);
+			auto bound = epsilon * g.order() * (g.order() - 2);
+			for (auto v : g.verts()) {
+				REQUIRE(exact(v) == Approx(expected(v)).margin(1e-9));
+				REQUIRE(std::abs(approximate(v) - expected(v)) <= bound);
+			}
+		}
+		WHEN("approximating personalized PageRank") {
+			auto s = gt.random_vert(r);
+			const double damping = 0.85, epsilon = 1e-4;
+			auto ranks = g.personalized_pagerank(s, damping, epsilon);
+			// Compare against power iteration restarting at `s`, with mass reaching vertices without out-edges also returning to `s`
+			auto exact = g.vert_map(0.0);
+			exact[s] = 1;
+			for (int i = 0; i < 1000; ++i) {
+				auto next = g.vert_map(0.0);
+				next[s] = 1 - damping;
+				for (auto v : g.verts())
+					if (g.out_degree(v) == 0)
+						next[s] += damping * exact(v);
+				for (auto e : g.edges())
+					next[g.head(e)] += damping * exact(g.tail(e)) / g.out_degree(g.tail(e));
+				exact = std::move(next);
+			}
+			auto approximate = g.vert_map(0.0);
+			for (std::size_t i = 0; i < ranks.size(); ++i) {
+				if (i > 0)
+					REQUIRE(ranks[i - 1].second >= ranks[i].second);
+				approximate[ranks[i].first] = ranks[i].second;
+			}
+			double shortfall = 0;
+			for (auto v : g.verts()) {
+				REQUIRE(approximate(v) <= exact(v) + 1e-9);
+				shortfall += exact(v) - approximate(v);
+			}
+			REQUIRE(shortfall < epsilon * (g.order() + g.size()));
+		}
+		WHEN("traversing depth-first from every vertex") {
+			using Vert = G::Vert;
+			using Edge = G::Edge;
+			std::size_t time = 0;
+			using Times = decltype(g.vert_map(std::size_t{}));
+			auto discovered = g.vert_map(std::size_t{}), finished = g.vert_map(std::size_t{});
+			std::vector<Edge> tree, back, other;
+			struct Visitor : graph::Traversal_visitor {
+				std::size_t& time;
+				Times& discovered;
+				Times& finished;
+				std::vector<Edge>& tree;
+				std::vector<Edge>& back;
+				std::vector<Edge>& other;
+				void discover_vert(const Vert& v) { discovered[v] = ++time; }
+				void finish_vert(const Vert& v) { finished[v] = ++time; }
+				void tree_edge(const Edge& e) { tree.push_back(e); }
+				void back_edge(const Edge& e) { back.push_back(e); }
+				void forward_or_cross_edge(const Edge& e) { other.push_back(e); }
+			};
+			auto traversal = g.out_traversal();
+			std::size_t roots = 0;
+			for (auto v : g.verts()) {
+				roots += !traversal.discovered(v);
+				traversal.depth_first_from(v, Visitor{ {}, time, discovered, finished, tree, back, other });
+			}
+			// Verify every vertex is discovered and finished once, and every edge is classified once
+			REQUIRE(time == 2 * g.order());
+			REQUIRE(tree.size() == g.order() - roots);
+			REQUIRE(tree.size() + back.size() + other.size() == g.size());
+			// Verify the edges nest as the parenthesis theorem requires
+			for (auto e : tree) {
+				auto u = g.tail(e), v = g.head(e);
+				REQUIRE(discovered(u) < discovered(v));
+				REQUIRE(finished(v) < finished(u));
+			}
+			for (auto e : back) {
+				auto u = g.tail(e), v = g.head(e);
+				REQUIRE(discovered(v) <= discovered(u));
+				REQUIRE(finished(u) <= finished(v));
+			}
+			for (auto e : other)
+				REQUIRE(finished(g.head(e)) < finished(g.tail(e)));
+		}
+		WHEN("traversing breadth-first from a vertex") {
+			using Vert = G::Vert;
+			using Edge = G::Edge;
+			auto s = gt.random_vert(r);
+			auto [_, hops] = g.breadth_first_search_from(s);
+			std::vector<Vert> order;
+			std::size_t edges = 0;
+			struct Visitor : graph::Traversal_visitor {
+				std::vector<Vert>& order;
+				std::size_t& edges;
+				void discover_vert(const Vert& v) { order.push_back(v); }
+				void tree_edge(const Edge& e) { ++edges; }
+				void non_tree_edge(const Edge& e) { ++edges; }
+			};
+			auto traversal = g.out_traversal();
+			traversal.breadth_first_from(s, Visitor{ {}, order, edges });
+			// Verify vertices are discovered in order of distance, and only those reachable
+			for (std::size_t i = 1; i < order.size(); ++i)
+				REQUIRE(hops(order[i - 1]) <= hops(order[i]));
+			for (auto v : g.verts())
+				REQUIRE(traversal.discovered(v) == (hops(v) != std::numeric_limits<std::size_t>::max()));
+			traversal.reset();
+			for (auto v : g.verts())
+				REQUIRE(!traversal.discovered(v));
+		}
+		WHEN("traversing depth-first along a long path") {
+			// Deep enough that a recursive traversal would risk overflowing the stack
+			const std::size_t L = 100000;
+			auto s = gt.insert_vert(), v = s;
+			for (std::size_t i = 0; i < L; ++i) {
+				auto u = g.insert_vert();
+				g.insert_edge(v, u);
+				v = u;
+			}
+			std::size_t depth = 0, max_depth = 0;
+			struct Visitor : graph::Traversal_visitor {
+				std::size_t& depth;
+				std::size_t& max_depth;
+				void discover_vert(const G::Vert&) { max_depth = std::max(max_depth, ++depth); }
+				void finish_vert(const G::Vert&) { --depth; }
+			};
+			g.out_traversal().depth_first_from(s, Visitor{ {}, depth, max_depth });
+			REQUIRE(max_depth == L + 1);
+			REQUIRE(depth == 0);
+		}
 		WHEN("searching for the shortest paths between all pairs of vertices") {
 			auto weight = [](auto e) { return 1.0; };
-			auto [trees, distances] = g.all_pairs_shortest_paths(weight);
-			// Verify that the distances and trees agree
+			auto [paths, distances] = g.all_pairs_shortest_paths(weight);
+			// Verify that the distances and paths agree
 			for (auto s : g.verts()) {
 				for (auto t : g.verts()) {
-					auto path = trees(s).path_from_root_to(t);
+					auto path = paths.path(s, t);
 					if (g.is_null(path)) {
 						REQUIRE(distances(s)(t) >= g.order());
 					} else {
@@ -98,6 +328,196 @@ SCENARIO("stable out-adjacency lists behave properly", "[Stable_out_adjacency_li
 					REQUIRE(distances(s)(t) == distance_s(t));
 			}
 		}
+		WHEN("searching for the shortest paths between all pairs of vertices with negative weights") {
+			// Potential differences make some weights negative without creating negative cycles
+			auto potential = g.vert_map(0);
+			for (auto v : g.verts())
+				potential[v] = std::uniform_int_distribution(0, 20)(r);
+			auto weight = g.edge_map(0);
+			for (auto e : g.edges())
+				weight[e] = std::uniform_int_distribution(0, 10)(r) + potential(g.tail(e)) - potential(g.head(e));
+			auto [paths, expected] = g.all_pairs_shortest_paths(weight);
+			auto distances = g.all_pairs_shortest_paths_sparse(weight);
+			for (auto s : g.verts())
+				for (auto t : g.verts())
+					REQUIRE(distances(s)(t) == expected(s)(t));
+			// Verify streamed rows match, and each source is streamed once
+			auto streamed = g.vert_map(0);
+			g.all_pairs_shortest_paths_sparse(weight, [&](auto s, const auto& row) {
+				++streamed[s];
+				for (auto t : g.verts())
+					REQUIRE(row(t) == expected(s)(t));
+			});
+			for (auto s : g.verts())
+				REQUIRE(streamed(s) == 1);
+			// A negative cycle leaves no shortest paths, even where preconditions go unchecked
+			auto s = gt.random_vert(r), t = gt.insert_vert();
+			gt.insert_edge(s, t);
+			auto e = gt.insert_edge(t, s);
+			weight[e] = -1;
+			REQUIRE_THROWS_AS(g.all_pairs_shortest_paths_sparse(weight), graph::precondition_unmet);
+		}
+		WHEN("searching for shortest paths from a vertex with negative weights") {
+			auto potential = g.vert_map(0);
+			for (auto v : g.verts())
+				potential[v] = std::uniform_int_distribution(0, 20)(r);
+			auto weight = g.edge_map(0);
+			for (auto e : g.edges())
+				weight[e] = std::uniform_int_distribution(0, 10)(r) + potential(g.tail(e)) - potential(g.head(e));
+			auto [paths, expected] = g.all_pairs_shortest_paths(weight);
+			auto s = gt.random_vert(r);
+			auto check = [&](const auto& tree, const auto& distances) {
+				REQUIRE(tree.root() == s);
+				for (auto v : g.verts()) {
+					REQUIRE(distances(v) == expected(s)(v));
+					auto e = tree.in_edge_or_null(v);
+					if (e != g.null_edge()) {
+						REQUIRE(g.head(e) == v);
+						REQUIRE(distances(v) == distances(g.tail(e)) + weight(e));
+					} else {
+						REQUIRE((v == s || distances(v) == std::numeric_limits<int>::max()));
+					}
+				}
+			};
+			auto [bf_tree, bf_distances] = g.bellman_ford_shortest_paths_from(s, weight);
+			check(bf_tree, bf_distances);
+			auto [spfa_tree, spfa_distances] = g.spfa_shortest_paths_from(s, weight);
+			check(spfa_tree, spfa_distances);
+			// Closing a cycle through the source with enough negative weight makes the paths unbounded
+			auto t = gt.insert_vert();
+			gt.insert_edge(s, t);
+			auto e = gt.insert_edge(t, s);
+			weight[e] = -1;
+			REQUIRE_THROWS_AS(g.bellman_ford_shortest_paths_from(s, weight), graph::precondition_unmet);
+			REQUIRE_THROWS_AS(g.spfa_shortest_paths_from(s, weight), graph::precondition_unmet);
+		}
+		WHEN("maintaining shortest paths from a vertex as edges are inserted and weights decreased") {
+			auto weight = g.edge_map(0);
+			for (auto e : g.edges())
+				weight[e] = std::uniform_int_distribution(10, 100)(r);
+			auto s = gt.random_vert(r);
+			auto paths = g.dynamic_shortest_paths_from(s, weight);
+			REQUIRE(paths.source() == s);
+			for (int batch = 0; batch < 10; ++batch) {
+				std::vector<G::Edge> changed;
+				// Grow the graph, sometimes reaching a new vertex
+				auto v = batch % 3 ? g.random_vert(r) : gt.insert_vert();
+				auto e = gt.insert_edge(g.random_vert(r), v);
+				weight[e] = std::uniform_int_distribution(0, 100)(r);
+				changed.push_back(e);
+				for (int i = 0; i < 3; ++i) {
+					auto f = g.random_edge(r);
+					weight[f] = weight(f) / 2;
+					changed.push_back(f);
+				}
+				if (batch % 2)
+					paths.update(changed);
+				else
+					for (auto f : changed)
+						paths.update(f);
+				// Compare against searching from scratch
+				auto [tree, expected] = g.shortest_paths_from(s, weight);
+				for (auto u : g.verts()) {
+					REQUIRE(paths.distance(u) == expected(u));
+					auto f = paths.tree().in_edge_or_null(u);
+					if (f != g.null_edge()) {
+						REQUIRE(g.head(f) == u);
+						REQUIRE(paths.distance(u) == paths.distance(g.tail(f)) + weight(f));
+					}
+					if (expected(u) != std::numeric_limits<int>::max())
+						REQUIRE(paths.shortest_path(u).total(weight) == expected(u));
+				}
+			}
+		}
+		WHEN("finding the k shortest paths between vertices") {
+			// Small enough that every simple path can be enumerated
+			G h;
+			std::vector<G::Vert> verts;
+			for (int i = 0; i < 8; ++i)
+				verts.push_back(h.insert_vert());
+			for (int i = 0; i < 24; ++i)
+				h.insert_edge(h.random_vert(r), h.random_vert(r));
+			auto weight = h.edge_map(0);
+			for (auto e : h.edges())
+				weight[e] = std::uniform_int_distribution(1, 10)(r);
+			for (auto s : verts) {
+				for (auto t : verts) {
+					// Enumerate the lengths of all simple paths depth-first
+					std::vector<int> expected;
+					auto on_path = h.vert_map(0);
+					auto enumerate = [&](auto& self, G::Vert v, int length) -> void {
+						if (v == t) {
+							expected.push_back(length);
+							return;
+						}
+						on_path[v] = 1;
+						for (auto e : h.out_edges(v))
+							if (!on_path(h.head(e)))
+								self(self, h.head(e), length + weight(e));
+						on_path[v] = 0;
+					};
+					enumerate(enumerate, s, 0);
+					std::sort(expected.begin(), expected.end());
+					const std::size_t k = 10;
+					auto paths = h.k_shortest_paths(s, t, k, weight);
+					REQUIRE(paths.size() == std::min(k, expected.size()));
+					std::set<std::vector<G::Edge>> distinct;
+					for (std::size_t i = 0; i < paths.size(); ++i) {
+						REQUIRE(h.source(paths[i]) == s);
+						REQUIRE(h.target(paths[i]) == t);
+						REQUIRE(paths[i].total(weight) == expected[i]);
+						std::set<G::Vert> visited{ s };
+						std::vector<G::Edge> edges;
+						for (auto e : paths[i].edges()) {
+							REQUIRE(visited.insert(h.head(e)).second);
+							edges.push_back(e);
+						}
+						REQUIRE(distinct.insert(edges).second);
+					}
+				}
+			}
+			// A failing combination in the last spur search is reported to the caller
+			std::atomic<std::size_t> calls{ 0 };
+			std::size_t fail_at = 0;
+			auto combine = [&](int l, int r) {
+				if (++calls == fail_at)
+					throw std::runtime_error("combination failed");
+				return l + r;
+			};
+			h.k_shortest_paths(verts[0], verts[1], 10, weight, std::less<>{}, combine);
+			fail_at = calls;
+			calls = 0;
+			REQUIRE_THROWS_AS(h.k_shortest_paths(verts[0], verts[1], 10, weight, std::less<>{}, combine), std::runtime_error);
+		}
+		WHEN("searching for the shortest paths between all pairs of vertices with integer weights") {
+			auto weight = g.edge_map(0u);
+			for (auto e : g.edges())
+				weight[e] = std::uniform_int_distribution(1u, 10u)(r);
+			// Insert an extra vertex that is never reachable, so infinite distances must not overflow
+			gt.insert_vert();
+			auto [paths, distances] = g.all_pairs_shortest_paths(weight);
+			for (auto s : g.verts()) {
+				auto [tree, distance_s] = g.shortest_paths_from(s, weight);
+				for (auto t : g.verts()) {
+					REQUIRE(distances(s)(t) == distance_s(t));
+					// Verify paths are reconstructed exactly for reachable vertices
+					auto path = paths.path(s, t);
+					auto e = paths.in_edge_or_null(s, t);
+					if (s == t) {
+						REQUIRE(g.is_trivial(path));
+						REQUIRE(g.is_null(e));
+					} else if (tree.in_tree(t)) {
+						REQUIRE(g.head(e) == t);
+						REQUIRE(g.source(path) == s);
+						REQUIRE(g.target(path) == t);
+						REQUIRE(path.total(weight) == distance_s(t));
+					} else {
+						REQUIRE(g.is_null(e));
+						REQUIRE(g.is_null(path));
+					}
+				}
+			}
+		}
 	}
 	GIVEN("a complete out-adjacency list") {
 		std::mt19937 r;
@@ -188,6 +608,24 @@ SCENARIO("stable in-adjacency lists behave properly", "[Stable_in_adjacency_list
 			auto rg = g.reverse_view();
 			Out_edge_graph_tester rgt{rg};
 		}
+		WHEN("finding strongly connected components") {
+			auto [components, count] = g.scc();
+			auto reaches = [&](auto s, auto t) {
+				auto [tree, _] = g.shortest_paths_to(t, [](auto e) { return 1; });
+				return s == t || tree.in_tree(s);
+			};
+			// Verify vertices share a component exactly when they reach each other
+			std::set<std::size_t> distinct;
+			for (auto s : g.verts()) {
+				distinct.insert(components(s));
+				for (auto t : g.verts())
+					REQUIRE((components(s) == components(t)) == (reaches(s, t) && reaches(t, s)));
+			}
+			REQUIRE(distinct.size() == count);
+			// Verify components are numbered in topological order
+			for (auto e : g.edges())
+				REQUIRE(components(g.tail(e)) <= components(g.head(e)));
+		}
 		WHEN("searching for shortest paths to a vertex") {
 			auto t = gt.random_vert(r);
 			auto weight = g.edge_map(0.0);
@@ -323,6 +761,339 @@ SCENARIO("stable bi-adjacency lists behave properly", "[Stable_bi_adjacency_list
 				}
 			}
 		}
+		WHEN("searching for the shortest path between vertices with integer weights") {
+			auto weight = g.edge_map(0);
+			for (auto e : g.edges())
+				weight[e] = std::uniform_int_distribution(0, 10)(r);
+			gt.insert_vert();
+			std::vector<std::pair<G::Vert, G::Vert>> queries;
+			for (auto s : g.verts())
+				for (auto t : g.verts())
+					queries.emplace_back(s, t);
+			std::vector<G::Path> batch(queries.size(), g.null_path());
+			g.shortest_paths_batch(queries, weight, batch.begin());
+			auto query = batch.begin();
+			for (auto s : g.verts()) {
+				auto [tree, distance] = g.shortest_paths_from(s, weight);
+				for (auto t : g.verts()) {
+					for (const auto& path : { g.shortest_path(s, t, weight), g.parallel_shortest_path(s, t, weight), *query++ }) {
+						if (!tree.in_tree(t)) {
+							REQUIRE(g.is_null(path));
+						} else {
+							// Exact weights leave no slack, so the path must be exactly as short as Dijkstra's
+							REQUIRE(g.source(path) == s);
+							REQUIRE(g.target(path) == t);
+							REQUIRE(path.total(weight) == distance(t));
+						}
+					}
+				}
+			}
+			// A failing weight is reported to the caller
+			auto failing = [](G::Edge) -> int { throw std::runtime_error("weight unavailable"); };
+			REQUIRE_THROWS_AS(g.shortest_paths_batch(queries, failing, batch.begin()), std::runtime_error);
+		}
+		WHEN("searching for shortest paths with a contraction hierarchy") {
+			auto weight = g.edge_map(0u);
+			for (auto e : g.edges())
+				weight[e] = std::uniform_int_distribution(1u, 10u)(r);
+			auto ch = g.contraction_hierarchy(weight);
+			for (auto s : g.verts()) {
+				auto [tree, distance] = g.shortest_paths_from(s, weight);
+				for (auto t : g.verts()) {
+					auto path = ch.shortest_path(s, t);
+					REQUIRE(ch.distance(s, t) == distance(t));
+					if (s == t) {
+						REQUIRE(g.is_trivial(path));
+					} else if (!g.is_null(path)) {
+						// Verify the path starts and end in the correct places
+						REQUIRE(g.source(path) == s);
+						REQUIRE(g.target(path) == t);
+						// Verify the unpacked path is as short as Dijkstra's
+						REQUIRE(path.total(weight) == distance(t));
+					} else {
+						// Verify no path exists
+						REQUIRE(!tree.in_tree(t));
+					}
+				}
+			}
+		}
+		WHEN("searching for shortest paths guided by landmarks") {
+			auto weight = g.edge_map(0.0);
+			for (auto e : g.edges())
+				weight[e] = std::uniform_real_distribution(0.001, 1.0)(r);
+			auto landmarks = g.landmarks(weight, 4, r);
+			REQUIRE(landmarks.size() == 4);
+			for (auto s : g.verts()) {
+				auto [tree, distance] = g.shortest_paths_from(s, weight);
+				for (auto t : g.verts()) {
+					auto path = landmarks.shortest_path(s, t);
+					if (s == t) {
+						REQUIRE(g.is_trivial(path));
+					} else if (!g.is_null(path)) {
+						// Verify the path starts and end in the correct places
+						REQUIRE(g.source(path) == s);
+						REQUIRE(g.target(path) == t);
+						// Verify the path is as short as Dijkstra's and bounded below
+						REQUIRE(path.total(weight) == Approx(distance(t)));
+						REQUIRE(landmarks.lower_bound(s, t) <= distance(t));
+					} else {
+						// Verify no path exists
+						REQUIRE(!tree.in_tree(t));
+					}
+				}
+			}
+		}
+		WHEN("answering distance queries with hub labels") {
+			auto weight = g.edge_map(0u);
+			for (auto e : g.edges())
+				weight[e] = std::uniform_int_distribution(1u, 10u)(r);
+			auto labels = g.hub_labels(weight);
+			// Verify labels survive a round trip through their serialized form
+			std::stringstream ss;
+			labels.write(ss);
+			auto read = g.hub_labels<unsigned>(ss);
+			REQUIRE(read.hub_count() == labels.hub_count());
+			// Verify labels ordered by a hierarchy are also exact
+			auto ch = g.contraction_hierarchy(weight);
+			auto ranked = g.hub_labels(weight, [&](auto v) { return ch.rank(v); });
+			for (auto s : g.verts()) {
+				auto [tree, distance] = g.shortest_paths_from(s, weight);
+				for (auto t : g.verts()) {
+					REQUIRE(labels.distance(s, t) == distance(t));
+					REQUIRE(read.distance(s, t) == distance(t));
+					REQUIRE(ranked.distance(s, t) == distance(t));
+				}
+			}
+		}
+		WHEN("finding strongly connected components") {
+			auto [components, count] = g.scc();
+			auto reaches = [&](auto s, auto t) {
+				auto [_, hops] = g.breadth_first_search_from(s);
+				return hops(t) != std::numeric_limits<std::size_t>::max();
+			};
+			// Verify vertices share a component exactly when they reach each other
+			std::set<std::size_t> distinct;
+			for (auto s : g.verts()) {
+				distinct.insert(components(s));
+				for (auto t : g.verts())
+					REQUIRE((components(s) == components(t)) == (reaches(s, t) && reaches(t, s)));
+			}
+			REQUIRE(distinct.size() == count);
+			// Verify the condensation is acyclic
+			graph::Stable_bi_adjacency_list dag;
+			g.condensation(components, count, dag);
+			REQUIRE(dag.order() == count);
+			REQUIRE(dag.scc().second == count);
+		}
+		WHEN("searching breadth-first from a vertex") {
+			auto s = gt.random_vert(r);
+			auto [tree, hops] = g.breadth_first_search_from(s);
+			auto [_, distances] = g.shortest_paths_from(s, [](auto e) { return std::size_t{1}; });
+			REQUIRE(tree.root() == s);
+			for (auto v : g.verts()) {
+				REQUIRE(hops(v) == distances(v));
+				auto e = tree.in_edge_or_null(v);
+				if (e != g.null_edge()) {
+					REQUIRE(g.head(e) == v);
+					REQUIRE(hops(v) == hops(g.tail(e)) + 1);
+				} else {
+					REQUIRE((v == s || !tree.in_tree(v)));
+				}
+			}
+		}
+		WHEN("ranking vertices by PageRank") {
+			// An extra vertex without out-edges
+			gt.insert_vert();
+			auto ranks = g.pagerank(0.85, 1e-12);
+			// Verify the ranks sum to one and are a fixed point of the iteration
+			const double damping = 0.85;
+			auto expected = g.vert_map(0.0);
+			double total = 0, dangling = 0;
+			for (auto v : g.verts()) {
+				total += ranks(v);
+				if (g.out_degree(v) == 0)
+					dangling += ranks(v);
+			}
+			REQUIRE(std::abs(total - 1) < 1e-9);
+			for (auto e : g.edges())
+				expected[g.head(e)] += damping * ranks(g.tail(e)) / g.out_degree(g.tail(e));
+			for (auto v : g.verts())
+				REQUIRE(std::abs(ranks(v) - (expected(v) + (1 - damping + damping * dangling) / g.order())) < 1e-9);
+		}
+		WHEN("multiplying the adjacency matrix by vectors") {
+			auto weight = g.edge_map(0);
+			for (auto e : g.edges())
+				weight[e] = std::uniform_int_distribution(1, 10)(r);
+			auto a = g.adjacency_matrix(weight);
+			auto at = a.transpose();
+			const auto& index = a.index();
+			auto n = a.order();
+			// Weighted out- and in-degrees by arithmetic, gathering and scattering
+			std::vector<int> ones(n, 1);
+			auto out = graph::mxv(a, ones, graph::Plus_times<int>{});
+			auto in = graph::mxv(at, ones, graph::Plus_times<int>{});
+			auto in_sparse = graph::vxm(ones, a, graph::Plus_times<int>{});
+			for (auto v : g.verts()) {
+				int out_weight = 0, in_weight = 0;
+				for (auto e : g.out_edges(v))
+					out_weight += weight(e);
+				for (auto e : g.in_edges(v))
+					in_weight += weight(e);
+				REQUIRE(out[index(v)] == out_weight);
+				REQUIRE(in[index(v)] == in_weight);
+			}
+			for (std::size_t k = 0; k < in_sparse.size(); ++k)
+				REQUIRE(in_sparse.values[k] == in[in_sparse.indices[k]]);
+			auto s = gt.random_vert(r);
+			// Breadth-first levels, expanding the frontier masked by unvisited vertices
+			auto [_, hops] = g.breadth_first_search_from(s);
+			auto reachable = g.adjacency_matrix([](auto e) -> unsigned char { return 1; });
+			std::vector<std::size_t> level(n, std::numeric_limits<std::size_t>::max());
+			graph::Sparse_vector<unsigned char> frontier;
+			frontier.push_back(index(s), 1);
+			level[index(s)] = 0;
+			for (std::size_t l = 1; frontier.size(); ++l) {
+				frontier = graph::vxm(frontier, reachable, graph::Or_and{},
+					[&](std::size_t i) { return level[i] == std::numeric_limits<std::size_t>::max(); });
+				for (auto i : frontier.indices)
+					level[i] = l;
+			}
+			for (auto v : g.verts())
+				REQUIRE(level[index(v)] == hops(v));
+			// Bellman-Ford rounds as min-plus products with the transpose
+			const int inf = std::numeric_limits<int>::max();
+			std::vector<int> distance(n, inf);
+			distance[index(s)] = 0;
+			for (std::size_t round = 0; round < n; ++round) {
+				auto relaxed = graph::mxv(at, distance, graph::Min_plus<int>{});
+				for (std::size_t i = 0; i < n; ++i)
+					distance[i] = std::min(distance[i], relaxed[i]);
+			}
+			auto [tree, expected] = g.shortest_paths_from(s, weight);
+			for (auto v : g.verts())
+				REQUIRE(distance[index(v)] == expected(v));
+			// Products which cancel leave no entry
+			G cancel;
+			auto x = cancel.insert_vert(), y = cancel.insert_vert(), z = cancel.insert_vert();
+			auto xz = cancel.insert_edge(x, z);
+			cancel.insert_edge(y, z);
+			auto signs = cancel.adjacency_matrix([&](auto e) { return e == xz ? 1 : -1; });
+			auto sum = graph::vxm(std::vector<int>(cancel.order(), 1), signs, graph::Plus_times<int>{});
+			REQUIRE(sum.size() == 0);
+		}
+		WHEN("finding core numbers") {
+			// An isolated vertex and one with only a loop
+			gt.insert_vert();
+			auto v = gt.insert_vert();
+			gt.insert_edge(v, v);
+			auto cores = g.core_numbers(), parallel_cores = g.parallel_core_numbers();
+			// Compare against repeatedly deleting every vertex with too few remaining neighbors
+			auto expected = g.vert_map(std::size_t{});
+			auto removed = g.vert_map(0);
+			std::size_t remaining = g.order();
+			for (std::size_t k = 0; remaining; ++k) {
+				for (bool changed = true; changed;) {
+					changed = false;
+					for (auto v : g.verts()) {
+						if (removed(v))
+							continue;
+						std::size_t degree = 0;
+						for (auto e : g.out_edges(v))
+							degree += g.head(e) != v && !removed(g.head(e));
+						for (auto e : g.in_edges(v))
+							degree += g.tail(e) != v && !removed(g.tail(e));
+						if (degree <= k) {
+							removed[v] = 1;
+							expected[v] = k;
+							--remaining;
+							changed = true;
+						}
+					}
+				}
+			}
+			for (auto v : g.verts()) {
+				REQUIRE(cores(v) == expected(v));
+				REQUIRE(parallel_cores(v) == expected(v));
+			}
+		}
+		WHEN("ordering vertices topologically") {
+			// The random graph almost certainly has a cycle
+			REQUIRE(g.scc().second < g.order());
+			REQUIRE_THROWS_AS(g.topological_order(), graph::precondition_unmet);
+			REQUIRE_THROWS_AS(g.parallel_topological_order(), graph::precondition_unmet);
+			REQUIRE_THROWS_AS(g.dag_shortest_paths_from(g.random_vert(r), [](auto e) { return 1; }), graph::precondition_unmet);
+			// Direct edges from earlier to later vertices to make a DAG
+			G dag;
+			std::vector<G::Vert> verts;
+			for (std::size_t m = 0; m < M; ++m)
+				verts.push_back(dag.insert_vert());
+			for (std::size_t n = 0; n < N; ++n) {
+				auto i = std::uniform_int_distribution<std::size_t>(0, M - 1)(r),
+					j = std::uniform_int_distribution<std::size_t>(0, M - 1)(r);
+				if (i != j)
+					dag.insert_edge(verts[std::min(i, j)], verts[std::max(i, j)]);
+			}
+			for (auto order : { dag.topological_order(), dag.parallel_topological_order() }) {
+				REQUIRE(order.size() == dag.order());
+				auto position = dag.vert_map(std::size_t{});
+				for (std::size_t i = 0; i < order.size(); ++i)
+					position[order[i]] = i + 1;
+				for (auto v : dag.verts())
+					REQUIRE(position(v) > 0);
+				for (auto e : dag.edges())
+					REQUIRE(position(dag.tail(e)) < position(dag.head(e)));
+			}
+			auto weight = dag.edge_map(0);
+			for (auto e : dag.edges())
+				weight[e] = std::uniform_int_distribution(-5, 10)(r);
+			auto s = verts.front();
+			auto [shortest_tree, shortest] = dag.dag_shortest_paths_from(s, weight);
+			auto [longest_tree, longest] = dag.dag_longest_paths_from(s, weight);
+			// Compare against relaxing every edge as many times as there are vertices
+			const int inf = std::numeric_limits<int>::max(), ninf = std::numeric_limits<int>::lowest();
+			auto expected_shortest = dag.vert_map(inf), expected_longest = dag.vert_map(ninf);
+			expected_shortest[s] = expected_longest[s] = 0;
+			for (std::size_t m = 0; m < M; ++m) {
+				for (auto e : dag.edges()) {
+					auto u = dag.tail(e), v = dag.head(e);
+					if (expected_shortest(u) != inf)
+						expected_shortest[v] = std::min(expected_shortest(v), expected_shortest(u) + weight(e));
+					if (expected_longest(u) != ninf)
+						expected_longest[v] = std::max(expected_longest(v), expected_longest(u) + weight(e));
+				}
+			}
+			for (auto v : dag.verts()) {
+				REQUIRE(shortest(v) == expected_shortest(v));
+				REQUIRE(longest(v) == expected_longest(v));
+				auto e = shortest_tree.in_edge_or_null(v), f = longest_tree.in_edge_or_null(v);
+				if (e != dag.null_edge())
+					REQUIRE(shortest(v) == shortest(dag.tail(e)) + weight(e));
+				if (f != dag.null_edge())
+					REQUIRE(longest(v) == longest(dag.tail(f)) + weight(f));
+			}
+			// Unsigned weights have no value below zero to mark unreached vertices, which must not stop the source being relaxed
+			auto unsigned_weight = dag.edge_map(0u);
+			auto signed_weight = dag.edge_map(0);
+			for (auto e : dag.edges())
+				signed_weight[e] = unsigned_weight[e] = std::uniform_int_distribution(0u, 10u)(r);
+			auto [unsigned_tree, unsigned_longest] = dag.dag_longest_paths_from(s, unsigned_weight);
+			auto [signed_tree, signed_longest] = dag.dag_longest_paths_from(s, signed_weight);
+			for (auto v : dag.verts()) {
+				if (signed_longest(v) == ninf)
+					REQUIRE(unsigned_longest(v) == 0u);
+				else
+					REQUIRE(unsigned_longest(v) == static_cast<unsigned>(signed_longest(v)));
+			}
+			G chain;
+			auto a = chain.insert_vert(), b = chain.insert_vert(), c = chain.insert_vert();
+			chain.insert_edge(a, b);
+			chain.insert_edge(b, c);
+			chain.insert_edge(a, c);
+			auto [chain_tree, chain_longest] = chain.dag_longest_paths_from(a, chain.edge_map(1u));
+			REQUIRE(chain_longest(a) == 0u);
+			REQUIRE(chain_longest(b) == 1u);
+			REQUIRE(chain_longest(c) == 2u);
+		}
 		WHEN("searching for the shortest path between vertices in parallel") {
 			auto weight = g.edge_map(0.0);
 			const double epsilon = 0.001;
@@ -350,6 +1121,34 @@ SCENARIO("stable bi-adjacency lists behave properly", "[Stable_bi_adjacency_list
 				}
 			}
 		}
+		WHEN("searching in parallel through vertices of high degree") {
+			// Both ends of every path pass through a hub with enough edges to be examined by a loop of tasks
+			G hub;
+			auto s = hub.insert_vert(), t = hub.insert_vert();
+			auto out_hub = hub.insert_vert(), in_hub = hub.insert_vert();
+			hub.insert_edge(s, out_hub);
+			hub.insert_edge(in_hub, t);
+			for (std::size_t i = 0; i < 2000; ++i) {
+				auto v = hub.insert_vert();
+				hub.insert_edge(out_hub, v);
+				hub.insert_edge(v, in_hub);
+			}
+			auto weight = hub.edge_map(0);
+			for (auto e : hub.edges())
+				weight[e] = std::uniform_int_distribution(0, 1000)(r);
+			auto [tree, distance] = hub.shortest_paths_from(s, weight);
+			auto path = hub.parallel_shortest_path(s, t, weight);
+			REQUIRE(hub.source(path) == s);
+			REQUIRE(hub.target(path) == t);
+			REQUIRE(path.total(weight) == distance(t));
+			// A failing weight is reported to the caller
+			auto failing = [&](G::Edge e) -> int {
+				if (hub.tail(e) == out_hub)
+					throw std::runtime_error("weight unavailable");
+				return weight(e);
+			};
+			REQUIRE_THROWS_AS(hub.parallel_shortest_path(s, t, failing), std::runtime_error);
+		}
 	}
 }
 
@@ -467,6 +1266,46 @@ TEST_CASE("stable bidirectional adjacency list", "[benchmark]") {
 				REQUIRE(path.total(weight) >= 0);
 		}
 	}
+	BENCHMARK("find shortest path with a contraction hierarchy") {
+		auto weight = g.edge_map(0.0);
+		for (auto e : g.edges())
+			weight[e] = std::uniform_real_distribution<double>{}(r);
+		auto ch = g.contraction_hierarchy(weight);
+		for (auto s : g.verts()) {
+			auto path = ch.shortest_path(s, g.random_vert(r));
+			if (!g.is_null(path))
+				REQUIRE(path.total(weight) >= 0);
+		}
+	}
+	BENCHMARK("find shortest path guided by landmarks") {
+		auto weight = g.edge_map(0.0);
+		for (auto e : g.edges())
+			weight[e] = std::uniform_real_distribution<double>{}(r);
+		auto landmarks = g.landmarks(weight, 8, r);
+		for (auto s : g.verts()) {
+			auto path = landmarks.shortest_path(s, g.random_vert(r));
+			if (!g.is_null(path))
+				REQUIRE(path.total(weight) >= 0);
+		}
+	}
+	BENCHMARK("find distances with hub labels") {
+		auto weight = g.edge_map(0.0);
+		for (auto e : g.edges())
+			weight[e] = std::uniform_real_distribution<double>{}(r);
+		auto labels = g.hub_labels(weight);
+		for (auto s : g.verts())
+			REQUIRE(labels.distance(s, g.random_vert(r)) >= 0);
+	}
+	BENCHMARK("search breadth-first") {
+		for (std::size_t i = 0; i < 100; ++i) {
+			auto [tree, hops] = g.breadth_first_search_from(g.random_vert(r));
+			REQUIRE(tree.root() != g.null_vert());
+		}
+	}
+	BENCHMARK("find strongly connected components") {
+		auto [components, count] = g.scc();
+		REQUIRE(count <= g.order());
+	}
 	BENCHMARK("find shortest path in parallel") {
 		auto weight = g.edge_map(0.0);
 		for (auto e : g.edges())
@@ -3,6 +3,9 @@
 
 #include "Graph_tester.hpp"
 
+#include <set>
+#include <algorithm>
+
 SCENARIO("stable edge lists behave properly", "[Stable_edge_list]") {
 	using G = graph::Stable_edge_list;
 	GIVEN("an empty graph") {
@@ -50,6 +53,188 @@ SCENARIO("stable edge lists behave properly", "[Stable_edge_list]") {
 				t = gt.insert_vert();
 			gt.insert_edge(s, t);
 		}
+		WHEN("counting triangles") {
+			// Enough vertices and edges that some neighbor lists are intersected by galloping
+			std::vector<G::Vert> verts(g.verts().begin(), g.verts().end());
+			auto hub = gt.insert_vert();
+			for (auto v : verts)
+				gt.insert_edge(hub, v);
+			verts.push_back(hub);
+			auto adjacent = [&](auto u, auto v) {
+				for (auto e : g.edges())
+					if ((g.tail(e) == u && g.head(e) == v) || (g.tail(e) == v && g.head(e) == u))
+						return true;
+				return false;
+			};
+			std::size_t expected = 0;
+			auto triangles = g.vert_map(std::size_t{}), neighbors = g.vert_map(std::size_t{});
+			for (std::size_t i = 0; i < verts.size(); ++i) {
+				for (std::size_t j = i + 1; j < verts.size(); ++j) {
+					if (!adjacent(verts[i], verts[j]))
+						continue;
+					++neighbors[verts[i]];
+					++neighbors[verts[j]];
+					for (std::size_t k = j + 1; k < verts.size(); ++k) {
+						if (adjacent(verts[i], verts[k]) && adjacent(verts[j], verts[k])) {
+							++expected;
+							for (auto v : { verts[i], verts[j], verts[k] })
+								++triangles[v];
+						}
+					}
+				}
+			}
+			REQUIRE(g.count_triangles() == expected);
+			auto coefficients = g.clustering_coefficients();
+			for (auto v : g.verts()) {
+				auto d = neighbors(v);
+				REQUIRE(coefficients(v) == Approx(d < 2 ? 0.0 : 2.0 * triangles(v) / (d * (d - 1))));
+			}
+		}
+		WHEN("finding minimum spanning forests") {
+			// A separate larger graph, so that filter-Kruskal partitions the edges, with a few small components
+			G h;
+			std::vector<G::Vert> verts;
+			for (std::size_t m = 0; m < 500; ++m)
+				verts.push_back(h.insert_vert());
+			for (std::size_t n = 0; n < 2000; ++n) {
+				auto i = std::uniform_int_distribution<std::size_t>(0, verts.size() - 1);
+				h.insert_edge(verts[i(r)], verts[i(r)]);
+			}
+			h.insert_edge(h.insert_vert(), h.insert_vert());
+			h.insert_vert();
+			auto weight = h.edge_map(0);
+			for (auto e : h.edges())
+				weight[e] = std::uniform_int_distribution(0, 100)(r);
+			// Compare against Kruskal's algorithm with components merged naively
+			std::vector<G::Edge> sorted(h.edges().begin(), h.edges().end());
+			std::stable_sort(sorted.begin(), sorted.end(), [&](auto e, auto f) { return weight(e) < weight(f); });
+			auto label = h.vert_map(std::size_t{});
+			auto reset = [&] {
+				std::size_t i = 0;
+				for (auto v : h.verts())
+					label[v] = i++;
+			};
+			auto merge = [&](auto u, auto v) {
+				auto from = label(u), to = label(v);
+				if (from == to)
+					return false;
+				for (auto w : h.verts())
+					if (label(w) == from)
+						label[w] = to;
+				return true;
+			};
+			reset();
+			int expected = 0;
+			std::size_t count = h.order();
+			for (auto e : sorted) {
+				if (merge(h.tail(e), h.head(e))) {
+					expected += weight(e);
+					--count;
+				}
+			}
+			REQUIRE(count > 1);
+			for (auto forest : { h.minimum_spanning_forest(weight), h.minimum_spanning_forest_kruskal(weight) }) {
+				// Verify the forest is acyclic, spans every component, and is as light as Kruskal's
+				REQUIRE(forest.size() == h.order() - count);
+				reset();
+				int total = 0;
+				for (auto e : forest) {
+					REQUIRE(merge(h.tail(e), h.head(e)));
+					total += weight(e);
+				}
+				REQUIRE(total == expected);
+			}
+			auto forest = h.minimum_spanning_forest_kruskal(weight);
+			REQUIRE(std::is_sorted(forest.begin(), forest.end(), [&](auto e, auto f) { return weight(e) < weight(f); }));
+			// Enough edges that filter-Kruskal partitions in parallel
+			G big;
+			for (int i = 0; i < 2000; ++i)
+				big.insert_vert();
+			for (int i = 0; i < 40000; ++i)
+				big.insert_edge(big.random_vert(r), big.random_vert(r));
+			auto big_weight = big.edge_map(0);
+			for (auto e : big.edges())
+				big_weight[e] = std::uniform_int_distribution(0, 1000)(r);
+			auto boruvka = big.minimum_spanning_forest(big_weight), kruskal = big.minimum_spanning_forest_kruskal(big_weight);
+			REQUIRE(kruskal.size() == boruvka.size());
+			auto total = [&](const auto& forest) {
+				long sum = 0;
+				for (auto e : forest)
+					sum += big_weight(e);
+				return sum;
+			};
+			REQUIRE(total(kruskal) == total(boruvka));
+			REQUIRE(std::is_sorted(kruskal.begin(), kruskal.end(), [&](auto e, auto f) { return big_weight(e) < big_weight(f); }));
+		}
+		WHEN("finding connected components") {
+			// Add a small component and an isolated vertex to the random graph
+			auto u = gt.insert_vert(), v = gt.insert_vert();
+			gt.insert_edge(v, u);
+			gt.insert_vert();
+			auto [components, count] = g.connected_components();
+			// Compare against labels propagated along edges until nothing changes
+			auto label = g.vert_map(std::size_t{});
+			std::size_t i = 0;
+			for (auto v : g.verts())
+				label[v] = i++;
+			for (bool changed = true; changed;) {
+				changed = false;
+				for (auto e : g.edges()) {
+					auto l = std::min(label(g.tail(e)), label(g.head(e)));
+					for (auto w : { g.tail(e), g.head(e) }) {
+						if (label(w) != l) {
+							label[w] = l;
+							changed = true;
+						}
+					}
+				}
+			}
+			std::set<std::size_t> distinct;
+			for (auto s : g.verts()) {
+				distinct.insert(label(s));
+				for (auto t : g.verts())
+					REQUIRE((components(s) == components(t)) == (label(s) == label(t)));
+			}
+			REQUIRE(count == distinct.size());
+			REQUIRE(count >= 3);
+			// The disjoint sets behind this are reusable on their own
+			graph::Union_find<> sets(4);
+			REQUIRE(sets.unite(3, 1));
+			REQUIRE(!sets.unite(1, 3));
+			sets.grow(5);
+			REQUIRE(sets.find(3) == 1);
+			REQUIRE(sets.same(1, 3));
+			REQUIRE(!sets.same(0, 4));
+		}
+		WHEN("finding maximum flows") {
+			auto capacity = g.edge_map(0);
+			for (auto e : g.edges())
+				capacity[e] = std::uniform_int_distribution<int>(0, 10)(r);
+			for (int i = 0; i < 10; ++i) {
+				auto s = g.random_vert(r), t = g.random_vert(r);
+				if (s == t)
+					continue;
+				auto [value, flow, cut] = g.maximum_flow(s, t, capacity);
+				// The flow is feasible and conserved everywhere but the source and sink
+				auto net = g.vert_map(0);
+				for (auto e : g.edges()) {
+					REQUIRE(0 <= flow(e));
+					REQUIRE(flow(e) <= capacity(e));
+					net[g.tail(e)] -= flow(e);
+					net[g.head(e)] += flow(e);
+				}
+				for (auto v : g.verts())
+					REQUIRE(net(v) == (v == t ? value : v == s ? -value : 0));
+				// Its value matches the capacity of the cut, so both are optimal
+				REQUIRE(cut.contains(s));
+				REQUIRE(!cut.contains(t));
+				int cut_capacity = 0;
+				for (auto e : g.edges())
+					if (cut.contains(g.tail(e)) && !cut.contains(g.head(e)))
+						cut_capacity += capacity(e);
+				REQUIRE(value == cut_capacity);
+			}
+		}
 		WHEN("viewed in reverse") {
 			assert(g.size()); // sanity check on the test itself
 			auto rg = g.reverse_view();
@@ -78,11 +78,11 @@ SCENARIO("stable out node lists behave properly", "[Stable_out_node_list]") {
 		}
 		WHEN("searching for the shortest paths between all pairs of vertices") {
 			auto weight = [](auto e) { return 1.0; };
-			auto [trees, distances] = g.all_pairs_shortest_paths(weight);
-			// Verify that the distances and trees agree
+			auto [paths, distances] = g.all_pairs_shortest_paths(weight);
+			// Verify that the distances and paths agree
 			for (auto s : g.verts()) {
 				for (auto t : g.verts()) {
-					auto path = trees(s).path_from_root_to(t);
+					auto path = paths.path(s, t);
 					if (g.is_null(path)) {
 						REQUIRE(distances(s)(t) >= g.order());
 					} else {